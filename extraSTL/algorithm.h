@@ -0,0 +1,252 @@
+#ifndef EXTRASTL_ALGORITHM_H
+#define EXTRASTL_ALGORITHM_H
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <iterator>
+#include <numeric>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// 并行算法：把随机访问区间均分给多个线程处理，元素较少时退化为串行。
+// extrastl::vector 的迭代器就是指针，可以直接使用：
+//
+//     extrastl::vector<int> v = ...;
+//     extrastl::parallel::sort(v.begin(), v.end());
+//     auto sum = extrastl::parallel::reduce(v.begin(), v.end(), 0L);
+//
+// 传入的函数对象会被多个线程同时调用，必须是线程安全的。
+namespace extrastl {
+namespace parallel {
+
+// 元素个数少于该值时串行执行，线程的创建开销超过了并行的收益。
+const size_t SERIAL_THRESHOLD = 1 << 15;
+
+namespace detail {
+
+template <class RandomIt>
+void requireRandomAccess() {
+    static_assert(
+            std::is_base_of<std::random_access_iterator_tag,
+                            typename std::iterator_traits<
+                                    RandomIt>::iterator_category>::value,
+            "extrastl::parallel 算法要求随机访问迭代器");
+}
+
+// n 个元素划分的块数：不超过硬件线程数，且每块不少于 SERIAL_THRESHOLD / 2 个元素。
+inline unsigned chunkCount(size_t n) {
+    if (n < SERIAL_THRESHOLD) return 1;
+    unsigned hw = std::thread::hardware_concurrency();
+    if (hw == 0) hw = 2;
+    const size_t byGrain = n / (SERIAL_THRESHOLD / 2);
+    return static_cast<unsigned>(std::min<size_t>(hw, byGrain));
+}
+
+// 将 [0, n) 均分为 k 块，对第 i 块 [begin, end) 调用 f(i, begin, end)。
+// 第 0 块在当前线程执行，其余各块各开一个线程。
+// 任意一块抛出的异常会在所有线程结束后重新抛出；创建线程失败时
+// 同样先等待已启动的线程结束，再抛出 std::system_error。
+template <class F>
+void forEachChunk(size_t n, unsigned k, F f) {
+    if (k <= 1) {
+        f(0u, size_t(0), n);
+        return;
+    }
+    std::vector<std::exception_ptr> errors(k);
+    std::vector<std::thread>        threads;
+    threads.reserve(k - 1);
+
+    auto runChunk = [&](unsigned i) {
+        try {
+            f(i, n * i / k, n * (i + 1) / k);
+        } catch (...) { errors[i] = std::current_exception(); }
+    };
+    try {
+        for (unsigned i = 1; i != k; ++i) threads.emplace_back(runChunk, i);
+    } catch (...) {
+        // 创建线程失败，已启动的线程仍在使用 f 与 errors，等它们结束后再抛出
+        for (auto& t : threads) t.join();
+        throw;
+    }
+    runChunk(0);
+    for (auto& t : threads) t.join();
+
+    for (auto& e : errors) {
+        if (e) std::rethrow_exception(e);
+    }
+}
+}    // namespace detail
+
+// 对 [first, last) 中的每个元素调用 f，调用顺序不确定。
+template <class RandomIt, class UnaryFunction>
+void for_each(RandomIt first, RandomIt last, UnaryFunction f) {
+    detail::requireRandomAccess<RandomIt>();
+    const size_t n = last - first;
+    detail::forEachChunk(n, detail::chunkCount(n),
+                         [&](unsigned, size_t b, size_t e) {
+                             std::for_each(first + b, first + e, f);
+                         });
+}
+
+// 将 op 作用于 [first, last) 的结果写入 d_first 开始的区间，返回输出区间的尾后位置。
+template <class RandomIt, class OutputIt, class UnaryOperation>
+OutputIt transform(RandomIt first, RandomIt last, OutputIt d_first,
+                   UnaryOperation op) {
+    detail::requireRandomAccess<RandomIt>();
+    detail::requireRandomAccess<OutputIt>();
+    const size_t n = last - first;
+    detail::forEachChunk(n, detail::chunkCount(n),
+                         [&](unsigned, size_t b, size_t e) {
+                             std::transform(first + b, first + e, d_first + b,
+                                            op);
+                         });
+    return d_first + n;
+}
+
+// 用 op 归约 [first, last) 与 init。
+// 各块的部分结果按区间顺序合并，op 必须满足结合律，不要求交换律。
+template <class RandomIt, class T, class BinaryOperation>
+T reduce(RandomIt first, RandomIt last, T init, BinaryOperation op) {
+    detail::requireRandomAccess<RandomIt>();
+    const size_t   n = last - first;
+    const unsigned k = detail::chunkCount(n);
+    if (k <= 1) return std::accumulate(first, last, init, op);
+
+    // 每块非空，以块内第一个元素为初值，不需要 op 的单位元。
+    std::vector<T> partial(k, init);
+    detail::forEachChunk(n, k, [&](unsigned i, size_t b, size_t e) {
+        partial[i] = std::accumulate(first + b + 1, first + e,
+                                     static_cast<T>(*(first + b)), op);
+    });
+    for (const auto& p : partial) init = op(init, p);
+    return init;
+}
+
+template <class RandomIt, class T>
+T reduce(RandomIt first, RandomIt last, T init) {
+    return parallel::reduce(first, last, init, std::plus<T>());
+}
+
+// 返回 [first, last) 中第一个满足 pred 的元素，不存在时返回 last。
+// 各线程记录已找到的最小位置，超过该位置的块提前结束。
+template <class RandomIt, class UnaryPredicate>
+RandomIt find_if(RandomIt first, RandomIt last, UnaryPredicate pred) {
+    detail::requireRandomAccess<RandomIt>();
+    const size_t   n = last - first;
+    const unsigned k = detail::chunkCount(n);
+    if (k <= 1) return std::find_if(first, last, pred);
+
+    std::atomic<size_t> found(n);
+    detail::forEachChunk(n, k, [&](unsigned, size_t b, size_t e) {
+        for (size_t i = b; i != e; ++i) {
+            if (i >= found.load(std::memory_order_relaxed)) return;
+            if (pred(*(first + i))) {
+                size_t cur = found.load();
+                while (i < cur && !found.compare_exchange_weak(cur, i)) {}
+                return;
+            }
+        }
+    });
+    return first + found.load();
+}
+
+// 统计 [first, last) 中满足 pred 的元素个数。
+template <class RandomIt, class UnaryPredicate>
+typename std::iterator_traits<RandomIt>::difference_type count_if(
+        RandomIt first, RandomIt last, UnaryPredicate pred) {
+    detail::requireRandomAccess<RandomIt>();
+    using difference_type =
+            typename std::iterator_traits<RandomIt>::difference_type;
+    const size_t   n = last - first;
+    const unsigned k = detail::chunkCount(n);
+
+    std::vector<difference_type> partial(k, 0);
+    detail::forEachChunk(n, k, [&](unsigned i, size_t b, size_t e) {
+        partial[i] = std::count_if(first + b, first + e, pred);
+    });
+    return std::accumulate(partial.begin(), partial.end(), difference_type(0));
+}
+
+namespace detail {
+
+// 各块并行调用 sortChunk(begin, end) 排序，再逐轮两两 inplace_merge，
+// 每一轮内的合并也并行执行。inplace_merge 是稳定的，
+// 因此 sortChunk 稳定时整个排序也是稳定的。
+// k 为初始的段数，通常由 chunkCount 决定。
+template <class RandomIt, class Compare, class ChunkSort>
+void mergeSort(RandomIt first, RandomIt last, Compare comp,
+               ChunkSort sortChunk, unsigned k) {
+    const size_t n = last - first;
+    if (k > n) k = static_cast<unsigned>(n);
+    if (k <= 1) {
+        sortChunk(first, last);
+        return;
+    }
+
+    // bounds[i] 为第 i 个有序段的起点。
+    std::vector<size_t> bounds(k + 1);
+    for (unsigned i = 0; i <= k; ++i) bounds[i] = n * i / k;
+
+    forEachChunk(n, k, [&](unsigned i, size_t, size_t) {
+        sortChunk(first + bounds[i], first + bounds[i + 1]);
+    });
+
+    while (bounds.size() > 2) {
+        const size_t        segments = bounds.size() - 1;
+        std::vector<size_t> next;
+        for (size_t i = 0; i < segments; i += 2) next.push_back(bounds[i]);
+        next.push_back(n);
+
+        const auto pairs = static_cast<unsigned>(segments / 2);
+        forEachChunk(n, pairs, [&](unsigned i, size_t, size_t) {
+            std::inplace_merge(first + bounds[2 * i],
+                               first + bounds[2 * i + 1],
+                               first + bounds[2 * i + 2], comp);
+        });
+        bounds.swap(next);
+    }
+}
+
+template <class RandomIt, class Compare, class ChunkSort>
+void mergeSort(RandomIt first, RandomIt last, Compare comp,
+               ChunkSort sortChunk) {
+    mergeSort(first, last, comp, sortChunk, chunkCount(last - first));
+}
+}    // namespace detail
+
+// 与 std::sort 一样不稳定。
+template <class RandomIt, class Compare>
+void sort(RandomIt first, RandomIt last, Compare comp) {
+    detail::requireRandomAccess<RandomIt>();
+    detail::mergeSort(first, last, comp, [&](RandomIt b, RandomIt e) {
+        std::sort(b, e, comp);
+    });
+}
+
+template <class RandomIt>
+void sort(RandomIt first, RandomIt last) {
+    using value_type = typename std::iterator_traits<RandomIt>::value_type;
+    parallel::sort(first, last, std::less<value_type>());
+}
+
+// 稳定排序，相等元素保持原有的相对顺序。
+template <class RandomIt, class Compare>
+void stable_sort(RandomIt first, RandomIt last, Compare comp) {
+    detail::requireRandomAccess<RandomIt>();
+    detail::mergeSort(first, last, comp, [&](RandomIt b, RandomIt e) {
+        std::stable_sort(b, e, comp);
+    });
+}
+
+template <class RandomIt>
+void stable_sort(RandomIt first, RandomIt last) {
+    using value_type = typename std::iterator_traits<RandomIt>::value_type;
+    parallel::stable_sort(first, last, std::less<value_type>());
+}
+
+}    // namespace parallel
+}    // namespace extrastl
+
+#endif
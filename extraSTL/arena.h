@@ -0,0 +1,120 @@
+#ifndef EXTRASTL_ARENA_H
+#define EXTRASTL_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+
+namespace extrastl {
+
+// 单调增长的内存池（arena）。
+// 只向前移动指针分配内存，单次 deallocate 不回收任何空间；
+// 调用 release() 或析构时一次性释放所有内存块。
+// 适合生命周期相同的一批短期对象，例如一次请求中创建的所有容器。
+// 非线程安全。
+class arena {
+  public:
+    explicit arena(size_t blockSize = 64 * 1024)
+            : head_(nullptr), cur_(nullptr), end_(nullptr),
+              blockSize_(blockSize) {}
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+    ~arena() { release(); }
+
+    // 分配 bytes 字节、按 align 对齐的空间。
+    void* allocate(size_t bytes, size_t align = alignof(std::max_align_t)) {
+        char* p = alignUp(cur_, align);
+        if (cur_ == nullptr || p + bytes > end_) {
+            newBlock(bytes + align);
+            p = alignUp(cur_, align);
+        }
+        cur_ = p + bytes;
+        return p;
+    }
+
+    // 释放所有内存块，之前分配的指针全部失效。
+    void release() {
+        while (head_ != nullptr) {
+            block* next = head_->next;
+            std::free(head_);
+            head_ = next;
+        }
+        cur_ = end_ = nullptr;
+    }
+
+  private:
+    struct block {
+        block* next;
+    };
+
+    static char* alignUp(char* p, size_t align) {
+        auto n = reinterpret_cast<uintptr_t>(p);
+        return reinterpret_cast<char*>((n + align - 1) & ~(align - 1));
+    }
+
+    // 申请一个至少能容纳 minBytes 字节的新内存块。
+    void newBlock(size_t minBytes) {
+        const size_t headerSize =
+                (sizeof(block) + alignof(std::max_align_t) - 1)
+                & ~(alignof(std::max_align_t) - 1);
+        const size_t dataSize = minBytes > blockSize_ ? minBytes : blockSize_;
+        auto*        b = static_cast<block*>(std::malloc(headerSize + dataSize));
+        if (b == nullptr) throw std::bad_alloc();
+        b->next = head_;
+        head_   = b;
+        cur_    = reinterpret_cast<char*>(b) + headerSize;
+        end_    = cur_ + dataSize;
+    }
+
+    block* head_;
+    char*  cur_;
+    char*  end_;
+    size_t blockSize_;
+};
+
+// 从 arena 中分配内存的分配器，可用于 extrastl::vector 等容器：
+//
+//     extrastl::arena                                    a;
+//     extrastl::vector<int, extrastl::arenaAllocator<int>> v{
+//             extrastl::arenaAllocator<int>(a)};
+//
+// deallocate 为空操作，内存随 arena 统一释放，因此 arena 必须比使用它的容器活得更久。
+template <class T>
+class arenaAllocator {
+  public:
+    using value_type = T;
+
+    // 移动与交换时分配器随容器一起转移，可以直接接管内存。
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap            = std::true_type;
+
+    explicit arenaAllocator(arena& a) noexcept : arena_(&a) {}
+    template <class U>
+    arenaAllocator(const arenaAllocator<U>& other) noexcept
+            : arena_(other.arena_) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T*, size_t) noexcept {}
+
+    template <class U>
+    bool operator==(const arenaAllocator<U>& other) const noexcept {
+        return arena_ == other.arena_;
+    }
+    template <class U>
+    bool operator!=(const arenaAllocator<U>& other) const noexcept {
+        return arena_ != other.arena_;
+    }
+
+  private:
+    template <class U>
+    friend class arenaAllocator;
+
+    arena* arena_;
+};
+}    // namespace extrastl
+
+#endif
@@ -0,0 +1,502 @@
+#ifndef EXTRASTL_AVLTREE_H
+#define EXTRASTL_AVLTREE_H
+
+#include "pool.h"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace extrastl {
+
+template <class T>
+class AVLTNode {
+  public:
+    T         key;       // 关键字(键值)
+    AVLTNode* left;      // 左孩子
+    AVLTNode* right;     // 右孩子
+    AVLTNode* parent;    // 父结点
+    int       height;    // 以该结点为根的子树的高度，叶子为 1
+
+    // 以 args 原地构造键值，父结点与孩子均为空。
+    template <class... Args>
+    explicit AVLTNode(Args&&... args)
+            : key(std::forward<Args>(args)...), left(NULL), right(NULL),
+              parent(NULL), height(1) {}
+};
+
+// AVL 树：任一结点左右子树的高度差不超过 1，树高不超过约 1.44 log2(n)，
+// 比红黑树的 2 log2(n) 更矮，查找路径更短；代价是插入、删除时旋转更多。
+// 适合查找远多于修改的场景，接口与 RBTree 相同，可以互相替换。
+//
+// 与 RBTree 一样：键值之间用 Compare 比较，相等的键值按插入顺序排在右侧；
+// 结点从 nodePool 中分配，默认每棵树有自己的结点池，destroy() 时整块释放。
+template <class T, class Compare = std::less<T>>
+class AVLTree {
+  public:
+    using pool_type = nodePool<AVLTNode<T>>;
+
+  private:
+    AVLTNode<T>*               mRoot;    // 根结点
+    size_t                     mSize;    // 结点个数
+    Compare                    mComp;    // 键值比较函数
+    std::shared_ptr<pool_type> pool_;    // 结点内存池
+
+  public:
+    explicit AVLTree(const Compare& comp = Compare());
+    explicit AVLTree(std::shared_ptr<pool_type> pool,
+                     const Compare&             comp = Compare());
+    AVLTree(const AVLTree&) = delete;
+    AVLTree& operator=(const AVLTree&) = delete;
+    ~AVLTree();
+
+    size_t size() const { return mSize; }
+
+    // 按升序对每个键值调用 visit(const T&)
+    template <class Visitor>
+    void inOrder(Visitor visit) const;
+
+    // 查找"AVL树"中键值为key的节点，与 iterativeSearch 相同
+    AVLTNode<T>* search(T key) const;
+    // (非递归实现)查找"AVL树"中键值为key的节点
+    AVLTNode<T>* iterativeSearch(T key) const;
+
+    // 查找最小结点：返回最小结点的键值，空树时返回 T()。
+    T minimum() const;
+    // 查找最大结点：返回最大结点的键值，空树时返回 T()。
+    T maximum() const;
+
+    // 最小、最大结点，空树时返回 NULL
+    AVLTNode<T>* first() const { return minimum(mRoot); }
+    AVLTNode<T>* last() const { return maximum(mRoot); }
+
+    // 找结点(x)的后继结点。即，查找"AVL树中数据值大于该结点"的"最小结点"。
+    AVLTNode<T>* successor(AVLTNode<T>* x) const;
+    // 找结点(x)的前驱结点。即，查找"AVL树中数据值小于该结点"的"最大结点"。
+    AVLTNode<T>* predecessor(AVLTNode<T>* x) const;
+
+    // 将结点(key为节点键值)插入到AVL树中
+    void insert(T key);
+
+    // 删除结点(key为节点键值)
+    void remove(T key);
+
+    // 销毁AVL树
+    void destroy();
+
+  private:
+    // 查找最小结点：返回tree为根结点的AVL树的最小结点。
+    static AVLTNode<T>* minimum(AVLTNode<T>* tree);
+    // 查找最大结点：返回tree为根结点的AVL树的最大结点。
+    static AVLTNode<T>* maximum(AVLTNode<T>* tree);
+
+    static int heightOf(const AVLTNode<T>* x) {
+        return x != NULL ? x->height : 0;
+    }
+    // 由左右孩子重新计算 x 的高度
+    static void updateHeight(AVLTNode<T>* x) {
+        const int l = heightOf(x->left), r = heightOf(x->right);
+        x->height   = (l > r ? l : r) + 1;
+    }
+
+    // 在 x 的父结点（或根）中用 y 取代 x
+    void replaceChild(AVLTNode<T>* x, AVLTNode<T>* y);
+    // 左旋、右旋，返回旋转后子树的根
+    AVLTNode<T>* leftRotate(AVLTNode<T>* x);
+    AVLTNode<T>* rightRotate(AVLTNode<T>* y);
+    // 恢复 x 的平衡并更新高度，返回调整后子树的根
+    AVLTNode<T>* rebalance(AVLTNode<T>* x);
+    // 从 x 开始向上更新高度并恢复平衡
+    void retrace(AVLTNode<T>* x);
+    // 删除结点
+    void remove(AVLTNode<T>* node);
+
+    // 析构并归还整棵子树；仅析构键值，内存由内存池整块释放
+    void freeTree(AVLTNode<T>* tree);
+    void destroyKeys(AVLTNode<T>* tree);
+
+    // 从内存池中分配结点并以 args 构造键值
+    template <class... Args>
+    AVLTNode<T>* newNode(Args&&... args);
+    // 析构结点并归还给内存池
+    void deleteNode(AVLTNode<T>* node);
+
+    // 按后序对 tree 子树中的每个结点调用 f(node)，f 可以释放该结点
+    template <class F>
+    static void postOrderNodes(AVLTNode<T>* tree, F f);
+};
+
+/*
+ * 构造函数
+ */
+template <class T, class Compare>
+AVLTree<T, Compare>::AVLTree(const Compare& comp)
+        : AVLTree(std::make_shared<pool_type>(), comp) {}
+
+template <class T, class Compare>
+AVLTree<T, Compare>::AVLTree(std::shared_ptr<pool_type> pool,
+                             const Compare&             comp)
+        : mRoot(NULL), mSize(0), mComp(comp), pool_(std::move(pool)) {}
+
+/*
+ * 析构函数
+ */
+template <class T, class Compare>
+AVLTree<T, Compare>::~AVLTree() {
+    destroy();
+}
+
+/*
+ * 中序遍历"AVL树"，借助父指针迭代
+ */
+template <class T, class Compare>
+template <class Visitor>
+void AVLTree<T, Compare>::inOrder(Visitor visit) const {
+    for (AVLTNode<T>* x = minimum(mRoot); x != NULL; x = successor(x)) {
+        visit(static_cast<const T&>(x->key));
+    }
+}
+
+template <class T, class Compare>
+AVLTNode<T>* AVLTree<T, Compare>::search(T key) const {
+    return iterativeSearch(key);
+}
+
+/*
+ * (非递归实现)查找"AVL树"中键值为key的节点
+ */
+template <class T, class Compare>
+AVLTNode<T>* AVLTree<T, Compare>::iterativeSearch(T key) const {
+    AVLTNode<T>* x = mRoot;
+    while (x != NULL) {
+        if (mComp(key, x->key))
+            x = x->left;
+        else if (mComp(x->key, key))
+            x = x->right;
+        else
+            break;
+    }
+
+    return x;
+}
+
+/*
+ * 查找最小结点：返回tree为根结点的AVL树的最小结点。
+ */
+template <class T, class Compare>
+AVLTNode<T>* AVLTree<T, Compare>::minimum(AVLTNode<T>* tree) {
+    if (tree == NULL) return NULL;
+
+    while (tree->left != NULL) tree = tree->left;
+    return tree;
+}
+
+template <class T, class Compare>
+T AVLTree<T, Compare>::minimum() const {
+    AVLTNode<T>* p = minimum(mRoot);
+    return p != NULL ? p->key : T();
+}
+
+/*
+ * 查找最大结点：返回tree为根结点的AVL树的最大结点。
+ */
+template <class T, class Compare>
+AVLTNode<T>* AVLTree<T, Compare>::maximum(AVLTNode<T>* tree) {
+    if (tree == NULL) return NULL;
+
+    while (tree->right != NULL) tree = tree->right;
+    return tree;
+}
+
+template <class T, class Compare>
+T AVLTree<T, Compare>::maximum() const {
+    AVLTNode<T>* p = maximum(mRoot);
+    return p != NULL ? p->key : T();
+}
+
+/*
+ * 找结点(x)的后继结点
+ *
+ * x 有右孩子时为右子树的最小结点；否则沿父指针向上，
+ * 第一个把 x 所在子树作为左子树的祖先。
+ */
+template <class T, class Compare>
+AVLTNode<T>* AVLTree<T, Compare>::successor(AVLTNode<T>* x) const {
+    if (x->right != NULL) return minimum(x->right);
+
+    AVLTNode<T>* y = x->parent;
+    while (y != NULL && x == y->right) {
+        x = y;
+        y = y->parent;
+    }
+    return y;
+}
+
+/*
+ * 找结点(x)的前驱结点，与 successor 对称
+ */
+template <class T, class Compare>
+AVLTNode<T>* AVLTree<T, Compare>::predecessor(AVLTNode<T>* x) const {
+    if (x->left != NULL) return maximum(x->left);
+
+    AVLTNode<T>* y = x->parent;
+    while (y != NULL && x == y->left) {
+        x = y;
+        y = y->parent;
+    }
+    return y;
+}
+
+template <class T, class Compare>
+void AVLTree<T, Compare>::replaceChild(AVLTNode<T>* x, AVLTNode<T>* y) {
+    AVLTNode<T>* p = x->parent;
+    if (p == NULL)
+        mRoot = y;
+    else if (p->left == x)
+        p->left = y;
+    else
+        p->right = y;
+    if (y != NULL) y->parent = p;
+}
+
+/*
+ * 对AVL树的节点(x)进行左旋转
+ *
+ * 左旋示意图(对节点x进行左旋)：
+ *      px                              px
+ *     /                               /
+ *    x                               y
+ *   /  \      --(左旋)-->           / \
+ *  lx   y                          x  ry
+ *     /   \                       /  \
+ *    ly   ry                     lx  ly
+ */
+template <class T, class Compare>
+AVLTNode<T>* AVLTree<T, Compare>::leftRotate(AVLTNode<T>* x) {
+    AVLTNode<T>* y = x->right;
+
+    x->right = y->left;
+    if (y->left != NULL) y->left->parent = x;
+    replaceChild(x, y);
+    y->left   = x;
+    x->parent = y;
+
+    updateHeight(x);
+    updateHeight(y);
+    return y;
+}
+
+/*
+ * 对AVL树的节点(y)进行右旋转，与 leftRotate 对称
+ */
+template <class T, class Compare>
+AVLTNode<T>* AVLTree<T, Compare>::rightRotate(AVLTNode<T>* y) {
+    AVLTNode<T>* x = y->left;
+
+    y->left = x->right;
+    if (x->right != NULL) x->right->parent = y;
+    replaceChild(y, x);
+    x->right  = y;
+    y->parent = x;
+
+    updateHeight(y);
+    updateHeight(x);
+    return x;
+}
+
+/*
+ * 恢复平衡
+ *
+ * 左子树比右子树高 2：左孩子的右子树更高时先对左孩子左旋（LR 型），
+ * 再对 x 右旋（LL 型）。右子树更高时对称。
+ */
+template <class T, class Compare>
+AVLTNode<T>* AVLTree<T, Compare>::rebalance(AVLTNode<T>* x) {
+    const int balance = heightOf(x->left) - heightOf(x->right);
+    if (balance > 1) {
+        if (heightOf(x->left->left) < heightOf(x->left->right)) {
+            leftRotate(x->left);
+        }
+        return rightRotate(x);
+    }
+    if (balance < -1) {
+        if (heightOf(x->right->right) < heightOf(x->right->left)) {
+            rightRotate(x->right);
+        }
+        return leftRotate(x);
+    }
+    updateHeight(x);
+    return x;
+}
+
+/*
+ * 向上回溯
+ *
+ * 祖先的高度与平衡只取决于孩子的高度，某棵子树调整后高度不变时，
+ * 上面的结点都不受影响，可以提前结束。
+ */
+template <class T, class Compare>
+void AVLTree<T, Compare>::retrace(AVLTNode<T>* x) {
+    while (x != NULL) {
+        const int oldHeight = x->height;
+        x                   = rebalance(x);
+        if (x->height == oldHeight) return;
+        x = x->parent;
+    }
+}
+
+/*
+ * 将结点插入到AVL树中
+ *
+ * 先按二叉查找树插入，再从新结点的父结点向上恢复平衡，
+ * 至多旋转一次（或双旋一次）。
+ */
+template <class T, class Compare>
+void AVLTree<T, Compare>::insert(T key) {
+    AVLTNode<T>* y = NULL;
+    AVLTNode<T>* x = mRoot;
+    while (x != NULL) {
+        y = x;
+        x = mComp(key, x->key) ? x->left : x->right;
+    }
+
+    AVLTNode<T>* node = newNode(std::move(key));
+    node->parent      = y;
+    if (y == NULL)
+        mRoot = node;
+    else if (mComp(node->key, y->key))
+        y->left = node;
+    else
+        y->right = node;
+    ++mSize;
+
+    retrace(y);
+}
+
+/*
+ * 删除结点(node)
+ *
+ * node 有两个孩子时用其后继结点 y 取代 node 的位置（移动结点而非复制键值），
+ * 然后从结构发生变化的最低结点开始向上恢复平衡。
+ */
+template <class T, class Compare>
+void AVLTree<T, Compare>::remove(AVLTNode<T>* node) {
+    AVLTNode<T>* start;
+    if (node->left != NULL && node->right != NULL) {
+        AVLTNode<T>* y = minimum(node->right);
+        if (y->parent == node) {
+            start = y;
+        } else {
+            start       = y->parent;
+            start->left = y->right;
+            if (y->right != NULL) y->right->parent = start;
+            y->right            = node->right;
+            node->right->parent = y;
+        }
+        y->left            = node->left;
+        node->left->parent = y;
+        y->height          = node->height;
+        replaceChild(node, y);
+    } else {
+        start = node->parent;
+        replaceChild(node, node->left != NULL ? node->left : node->right);
+    }
+
+    deleteNode(node);
+    --mSize;
+    retrace(start);
+}
+
+template <class T, class Compare>
+void AVLTree<T, Compare>::remove(T key) {
+    AVLTNode<T>* node = iterativeSearch(key);
+    if (node != NULL) remove(node);
+}
+
+/*
+ * 后序遍历结点
+ *
+ * 先求出后序中的下一个结点再调用 f，因此 f 可以析构、释放当前结点。
+ */
+template <class T, class Compare>
+template <class F>
+void AVLTree<T, Compare>::postOrderNodes(AVLTNode<T>* tree, F f) {
+    if (tree == NULL) return;
+
+    auto firstPostOrder = [](AVLTNode<T>* x) {
+        while (x->left != NULL || x->right != NULL) {
+            x = x->left != NULL ? x->left : x->right;
+        }
+        return x;
+    };
+    AVLTNode<T>* x = firstPostOrder(tree);
+    for (;;) {
+        AVLTNode<T>* next = NULL;
+        if (x != tree) {
+            AVLTNode<T>* p = x->parent;
+            next = (x == p->left && p->right != NULL) ? firstPostOrder(p->right)
+                                                      : p;
+        }
+        f(x);
+        if (next == NULL) return;
+        x = next;
+    }
+}
+
+template <class T, class Compare>
+void AVLTree<T, Compare>::destroyKeys(AVLTNode<T>* tree) {
+    postOrderNodes(tree, [](AVLTNode<T>* x) { x->~AVLTNode<T>(); });
+}
+
+template <class T, class Compare>
+void AVLTree<T, Compare>::freeTree(AVLTNode<T>* tree) {
+    postOrderNodes(tree, [this](AVLTNode<T>* x) { deleteNode(x); });
+}
+
+/*
+ * 销毁AVL树
+ */
+template <class T, class Compare>
+void AVLTree<T, Compare>::destroy() {
+    if (pool_.use_count() == 1) {
+        // 结点池只属于本树：键值可平凡析构时不需要遍历，直接释放整个内存池。
+        if (!std::is_trivially_destructible<T>::value) destroyKeys(mRoot);
+        pool_->release();
+    } else {
+        // 结点池与其他树共用，只能逐个归还
+        freeTree(mRoot);
+    }
+    mRoot = NULL;
+    mSize = 0;
+}
+
+/*
+ * 从内存池中分配并构造结点
+ */
+template <class T, class Compare>
+template <class... Args>
+AVLTNode<T>* AVLTree<T, Compare>::newNode(Args&&... args) {
+    AVLTNode<T>* node = pool_->allocate();
+    try {
+        ::new (static_cast<void*>(node))
+                AVLTNode<T>(std::forward<Args>(args)...);
+    } catch (...) {
+        pool_->deallocate(node);
+        throw;
+    }
+    return node;
+}
+
+/*
+ * 析构结点并归还给内存池
+ */
+template <class T, class Compare>
+void AVLTree<T, Compare>::deleteNode(AVLTNode<T>* node) {
+    node->~AVLTNode<T>();
+    pool_->deallocate(node);
+}
+}    // namespace extrastl
+
+#endif
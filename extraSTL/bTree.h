@@ -0,0 +1,514 @@
+#ifndef EXTRASTL_BTREE_H
+#define EXTRASTL_BTREE_H
+
+#include "pool.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace extrastl {
+namespace detail {
+
+// B+ 树结点的公共部分
+struct bTreeNodeBase {
+    size_t count;    // 叶结点中的元素个数，内部结点中的分隔键个数
+    bool   leaf;
+    explicit bTreeNodeBase(bool isLeaf) : count(0), leaf(isLeaf) {}
+};
+
+// 每个结点放得下的元素个数：NodeBytes 扣除结点头部后能放下的槽数，至少为 3
+constexpr size_t bTreeCapacity(size_t bytes, size_t header, size_t slot) {
+    return bytes > header + 3 * slot ? (bytes - header) / slot : 3;
+}
+
+// 叶结点：连续存放至多 Capacity 个有序元素，叶结点之间按顺序双向链接。
+template <class T, size_t Capacity>
+struct bTreeLeaf : bTreeNodeBase {
+    bTreeLeaf* prev;
+    bTreeLeaf* next;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type buffer[Capacity];
+
+    bTreeLeaf() : bTreeNodeBase(true), prev(nullptr), next(nullptr) {}
+    T* data() { return reinterpret_cast<T*>(buffer); }
+};
+
+// 内部结点：count 个分隔键与 count + 1 个孩子。
+// children[i] 中的元素 <= keys[i] <= children[i + 1] 中的元素。
+template <class T, size_t Capacity>
+struct bTreeInner : bTreeNodeBase {
+    bTreeNodeBase* children[Capacity + 1];
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type buffer[Capacity];
+
+    bTreeInner() : bTreeNodeBase(false) {}
+    T* keys() { return reinterpret_cast<T*>(buffer); }
+};
+}    // namespace detail
+
+// B+ 树：每个结点约占 NodeBytes 字节（默认 4 个缓存行），元素只存放在叶结点中。
+// 与 RBTree 一样提供 insert、remove、search、minimum、maximum 与 inOrder，
+// 两者可以互相替换。
+//
+// RBTree 每个元素一个结点，查找每下降一层大约一次缓存未命中；
+// B+ 树每层在一个结点内二分查找，树高约为 log_B(n)，B 为每个结点的元素个数，
+// 缓存未命中次数相应地减少，顺序遍历则是沿叶结点链表的连续访问。
+//
+// 与 RBTree 一样允许等价的键，新插入的键排在等价键之后。
+// 插入、删除会移动结点内的元素，元素的地址不稳定。
+// 结点从本树独有的 nodePool 中分配，destroy() 时整块释放。
+template <class T, class Compare = std::less<T>, size_t NodeBytes = 256>
+class BTree {
+  private:
+    using nodeBase = detail::bTreeNodeBase;
+
+  public:
+    // 叶结点的元素个数上限、内部结点的分隔键个数上限
+    static const size_t LEAF_CAPACITY = detail::bTreeCapacity(
+            NodeBytes, sizeof(nodeBase) + 2 * sizeof(void*), sizeof(T));
+    static const size_t INNER_CAPACITY =
+            detail::bTreeCapacity(NodeBytes, sizeof(nodeBase) + sizeof(void*),
+                                  sizeof(T) + sizeof(void*));
+
+  private:
+    using leafNode  = detail::bTreeLeaf<T, LEAF_CAPACITY>;
+    using innerNode = detail::bTreeInner<T, INNER_CAPACITY>;
+
+    // 除根结点外，结点的最少元素（分隔键）个数。
+    // 满结点分裂后两半都不少于下限，低于下限的结点与兄弟合并后不超过上限。
+    static const size_t LEAF_MIN  = LEAF_CAPACITY / 2;
+    static const size_t INNER_MIN = (INNER_CAPACITY - 1) / 2;
+
+    nodeBase*           root_;
+    leafNode*           head_;    // 最小元素所在的叶结点
+    leafNode*           tail_;    // 最大元素所在的叶结点
+    size_t              size_;
+    Compare             comp_;
+    nodePool<leafNode>  leafPool_;
+    nodePool<innerNode> innerPool_;
+
+  public:
+    // **************************************************************
+    // ************************构造函数*******************************
+    // **************************************************************
+    explicit BTree(const Compare& comp = Compare())
+            : root_(nullptr), head_(nullptr), tail_(nullptr), size_(0),
+              comp_(comp) {}
+    BTree(const BTree&) = delete;
+    BTree& operator=(const BTree&) = delete;
+    ~BTree() { destroy(); }
+
+    bool   empty() const { return size_ == 0; }
+    size_t size() const { return size_; }
+
+    // 与 key 等价的元素，不存在时返回 nullptr。
+    // 返回的指针在下一次插入、删除之前有效。
+    template <class K>
+    const T* search(const K& key) const {
+        leafNode* n;
+        size_t    i;
+        lowerBound(key, n, i);
+        if (n == nullptr || comp_(key, n->data()[i])) return nullptr;
+        return n->data() + i;
+    }
+
+    // 最小、最大元素，树不能为空
+    const T& minimum() const {
+        assert(size_ != 0);
+        return head_->data()[0];
+    }
+    const T& maximum() const {
+        assert(size_ != 0);
+        return tail_->data()[tail_->count - 1];
+    }
+
+    // 按升序对每个元素、[lo, hi) 中的每个元素调用 visit(const T&)
+    template <class Visitor>
+    void inOrder(Visitor visit) const {
+        for (leafNode* n = head_; n != nullptr; n = n->next) {
+            const T* d = n->data();
+            for (size_t i = 0; i != n->count; ++i) visit(d[i]);
+        }
+    }
+    template <class K1, class K2, class Visitor>
+    void inOrder(const K1& lo, const K2& hi, Visitor visit) const {
+        leafNode* n;
+        size_t    i;
+        for (lowerBound(lo, n, i); n != nullptr; n = n->next, i = 0) {
+            const T* d = n->data();
+            for (; i != n->count; ++i) {
+                if (!comp_(d[i], hi)) return;
+                visit(d[i]);
+            }
+        }
+    }
+
+    // 插入 key，排在已有的等价键之后
+    void insert(T key);
+
+    // 删除一个与 key 等价的元素，不存在时什么也不做
+    template <class K>
+    void remove(const K& key) {
+        if (root_ == nullptr || !removeFrom(root_, key)) return;
+        --size_;
+        if (root_->count != 0) return;
+        // 根结点为空：内部结点由唯一的孩子取代，叶结点则树变为空
+        nodeBase* old = root_;
+        if (old->leaf) {
+            root_ = nullptr;
+            head_ = tail_ = nullptr;
+            deleteLeaf(static_cast<leafNode*>(old));
+        } else {
+            root_ = inner(old)->children[0];
+            deleteInner(inner(old));
+        }
+    }
+
+    // 销毁全部元素
+    void destroy() {
+        if (!std::is_trivially_destructible<T>::value) destroyKeys(root_);
+        leafPool_.release();
+        innerPool_.release();
+        root_ = nullptr;
+        head_ = tail_ = nullptr;
+        size_         = 0;
+    }
+
+  private:
+    static leafNode*  leaf(nodeBase* n) { return static_cast<leafNode*>(n); }
+    static innerNode* inner(nodeBase* n) { return static_cast<innerNode*>(n); }
+
+    static size_t capacityOf(const nodeBase* n) {
+        return n->leaf ? LEAF_CAPACITY : INNER_CAPACITY;
+    }
+    static size_t minOf(const nodeBase* n) {
+        return n->leaf ? LEAF_MIN : INNER_MIN;
+    }
+
+    static void destroy(T* first, T* last) {
+        for (; first != last; ++first) first->~T();
+    }
+    // 在 d[pos] 处构造元素，d 中原有 count 个元素
+    template <class V>
+    static void insertAt(T* d, size_t count, size_t pos, V&& value) {
+        detail::shiftRight(d + pos, d + count, 1);
+        ::new (static_cast<void*>(d + pos)) T(std::forward<V>(value));
+    }
+    // 删除 d[pos]，d 中原有 count 个元素
+    static void eraseAt(T* d, size_t count, size_t pos) {
+        detail::shiftLeft(d + pos + 1, d + count, d + pos);
+        d[count - 1].~T();
+    }
+
+    leafNode*  newLeaf() { return ::new (leafPool_.allocate()) leafNode; }
+    innerNode* newInner() { return ::new (innerPool_.allocate()) innerNode; }
+    void       deleteLeaf(leafNode* n) { leafPool_.deallocate(n); }
+    void       deleteInner(innerNode* n) { innerPool_.deallocate(n); }
+
+    void destroyKeys(nodeBase* n);
+
+    // 第一个不小于 key 的元素所在的叶结点与下标，不存在时 n 为 nullptr
+    template <class K>
+    void lowerBound(const K& key, leafNode*& n, size_t& i) const;
+
+    // 把 parent 的第 i 个孩子（满结点）对半分裂，右半部分成为第 i + 1 个孩子
+    void splitChild(innerNode* parent, size_t i);
+    // 在 parent 的第 i 个分隔键处插入 sep，child 成为第 i + 1 个孩子
+    static void insertChild(innerNode* parent, size_t i, T&& sep,
+                            nodeBase* child);
+
+    // 从子树 n 中删除一个与 key 等价的元素，返回是否找到
+    template <class K>
+    bool removeFrom(nodeBase* n, const K& key);
+    // parent 的第 i 个孩子低于下限时，向兄弟借一个元素或与兄弟合并
+    void fixUnderflow(innerNode* parent, size_t i);
+    // 把 parent 的第 i + 1 个孩子并入第 i 个孩子
+    void mergeChildren(innerNode* parent, size_t i);
+};
+
+template <class T, class Compare, size_t NodeBytes>
+const size_t BTree<T, Compare, NodeBytes>::LEAF_CAPACITY;
+template <class T, class Compare, size_t NodeBytes>
+const size_t BTree<T, Compare, NodeBytes>::INNER_CAPACITY;
+template <class T, class Compare, size_t NodeBytes>
+const size_t BTree<T, Compare, NodeBytes>::LEAF_MIN;
+template <class T, class Compare, size_t NodeBytes>
+const size_t BTree<T, Compare, NodeBytes>::INNER_MIN;
+
+/*
+ * 析构子树中的全部键，结点内存由 destroy() 随内存池整块释放
+ */
+template <class T, class Compare, size_t NodeBytes>
+void BTree<T, Compare, NodeBytes>::destroyKeys(nodeBase* n) {
+    if (n == nullptr) return;
+    if (n->leaf) {
+        destroy(leaf(n)->data(), leaf(n)->data() + n->count);
+        return;
+    }
+    innerNode* in = inner(n);
+    for (size_t i = 0; i <= in->count; ++i) destroyKeys(in->children[i]);
+    destroy(in->keys(), in->keys() + in->count);
+}
+
+/*
+ * 查找第一个不小于 key 的元素
+ *
+ * 每层走向第一个不小于 key 的分隔键左侧的孩子。分隔键可能等于 key 而
+ * 左侧孩子中已经没有 key，此时结果是下一个叶结点的第一个元素。
+ */
+template <class T, class Compare, size_t NodeBytes>
+template <class K>
+void BTree<T, Compare, NodeBytes>::lowerBound(const K& key, leafNode*& n,
+                                              size_t& i) const {
+    n = nullptr;
+    if (root_ == nullptr) return;
+
+    nodeBase* x = root_;
+    while (!x->leaf) {
+        innerNode* in = inner(x);
+        const T*   k  = in->keys();
+        x = in->children[std::lower_bound(k, k + in->count, key, comp_) - k];
+    }
+    leafNode* l = leaf(x);
+    const T*  d = l->data();
+    i           = std::lower_bound(d, d + l->count, key, comp_) - d;
+    if (i == l->count) {
+        l = l->next;
+        i = 0;
+    }
+    n = l;
+}
+
+/*
+ * 插入
+ *
+ * 自顶向下插入：下降途中遇到满结点先分裂，因此分裂时父结点总有空位，
+ * 不需要再回溯。每层走向第一个大于 key 的分隔键左侧的孩子，
+ * 新元素排在等价键之后。
+ */
+template <class T, class Compare, size_t NodeBytes>
+void BTree<T, Compare, NodeBytes>::insert(T key) {
+    if (root_ == nullptr) {
+        root_ = head_ = tail_ = newLeaf();
+    }
+    if (root_->count == capacityOf(root_)) {
+        innerNode* r   = newInner();
+        r->children[0] = root_;
+        root_          = r;
+        splitChild(r, 0);
+    }
+
+    nodeBase* x = root_;
+    while (!x->leaf) {
+        innerNode* in = inner(x);
+        const T*   k  = in->keys();
+        size_t     i  = std::upper_bound(k, k + in->count, key, comp_) - k;
+        if (in->children[i]->count == capacityOf(in->children[i])) {
+            splitChild(in, i);
+            if (!comp_(key, in->keys()[i])) ++i;
+        }
+        x = in->children[i];
+    }
+
+    leafNode* l = leaf(x);
+    T*        d = l->data();
+    size_t    i = std::upper_bound(d, d + l->count, key, comp_) - d;
+    insertAt(d, l->count, i, std::move(key));
+    ++l->count;
+    ++size_;
+}
+
+/*
+ * 分裂满结点
+ *
+ * 叶结点：后一半元素移到新叶结点，新叶结点第一个元素的副本作为分隔键。
+ * 内部结点：中间的分隔键上移到父结点，其后的键与孩子移到新结点。
+ */
+template <class T, class Compare, size_t NodeBytes>
+void BTree<T, Compare, NodeBytes>::splitChild(innerNode* parent, size_t i) {
+    nodeBase* c = parent->children[i];
+    if (c->leaf) {
+        leafNode*    l   = leaf(c);
+        const size_t mid = l->count / 2;
+        T*           d   = l->data();
+        T            sep(d[mid]);
+        leafNode*    r   = newLeaf();
+        detail::uninitializedRelocate(d + mid, d + l->count, r->data());
+        destroy(d + mid, d + l->count);
+        r->count = l->count - mid;
+        l->count = mid;
+
+        r->prev = l;
+        r->next = l->next;
+        if (l->next != nullptr)
+            l->next->prev = r;
+        else
+            tail_ = r;
+        l->next = r;
+        insertChild(parent, i, std::move(sep), r);
+    } else {
+        innerNode*   l   = inner(c);
+        innerNode*   r   = newInner();
+        const size_t mid = l->count / 2;
+        T*           k   = l->keys();
+        detail::uninitializedRelocate(k + mid + 1, k + l->count, r->keys());
+        std::copy(l->children + mid + 1, l->children + l->count + 1,
+                  r->children);
+        r->count = l->count - mid - 1;
+
+        T sep(std::move(k[mid]));
+        destroy(k + mid, k + l->count);
+        l->count = mid;
+        insertChild(parent, i, std::move(sep), r);
+    }
+}
+
+template <class T, class Compare, size_t NodeBytes>
+void BTree<T, Compare, NodeBytes>::insertChild(innerNode* parent, size_t i,
+                                               T&& sep, nodeBase* child) {
+    insertAt(parent->keys(), parent->count, i, std::move(sep));
+    std::copy_backward(parent->children + i + 1,
+                       parent->children + parent->count + 1,
+                       parent->children + parent->count + 2);
+    parent->children[i + 1] = child;
+    ++parent->count;
+}
+
+/*
+ * 删除
+ *
+ * 分隔键可能与 key 等价，等价的元素可能分布在相邻的几个孩子中，
+ * 因此从第一个不小于 key 的分隔键左侧的孩子开始，依次尝试分隔键
+ * 等于 key 的后续孩子。删除后孩子低于下限时由 fixUnderflow 修复。
+ */
+template <class T, class Compare, size_t NodeBytes>
+template <class K>
+bool BTree<T, Compare, NodeBytes>::removeFrom(nodeBase* n, const K& key) {
+    if (n->leaf) {
+        leafNode* l = leaf(n);
+        T*        d = l->data();
+        size_t    i = std::lower_bound(d, d + l->count, key, comp_) - d;
+        if (i == l->count || comp_(key, d[i])) return false;
+        eraseAt(d, l->count, i);
+        --l->count;
+        return true;
+    }
+
+    innerNode* in = inner(n);
+    const T*   k  = in->keys();
+    for (size_t i = std::lower_bound(k, k + in->count, key, comp_) - k;
+         i <= in->count; ++i) {
+        if (removeFrom(in->children[i], key)) {
+            fixUnderflow(in, i);
+            return true;
+        }
+        if (i == in->count || comp_(key, k[i])) break;
+    }
+    return false;
+}
+
+/*
+ * 修复低于下限的孩子
+ *
+ * 兄弟结点多于下限时借一个过来：叶结点直接移动元素并更新分隔键，
+ * 内部结点经由父结点的分隔键旋转。否则与兄弟合并，合并后不超过上限。
+ */
+template <class T, class Compare, size_t NodeBytes>
+void BTree<T, Compare, NodeBytes>::fixUnderflow(innerNode* parent, size_t i) {
+    nodeBase* c = parent->children[i];
+    if (c->count >= minOf(c)) return;
+
+    nodeBase* left  = i > 0 ? parent->children[i - 1] : nullptr;
+    nodeBase* right = i < parent->count ? parent->children[i + 1] : nullptr;
+    T*        sep   = parent->keys();
+
+    if (left != nullptr && left->count > minOf(left)) {
+        if (c->leaf) {
+            T* from = leaf(left)->data() + left->count - 1;
+            insertAt(leaf(c)->data(), c->count, 0, std::move(*from));
+            from->~T();
+            sep[i - 1] = leaf(c)->data()[0];
+        } else {
+            innerNode* l = inner(left);
+            innerNode* x = inner(c);
+            insertAt(x->keys(), x->count, 0, std::move(sep[i - 1]));
+            std::copy_backward(x->children, x->children + x->count + 1,
+                               x->children + x->count + 2);
+            x->children[0] = l->children[l->count];
+            sep[i - 1]     = std::move(l->keys()[l->count - 1]);
+            l->keys()[l->count - 1].~T();
+        }
+        --left->count;
+        ++c->count;
+    } else if (right != nullptr && right->count > minOf(right)) {
+        if (c->leaf) {
+            T* d = leaf(right)->data();
+            ::new (static_cast<void*>(leaf(c)->data() + c->count))
+                    T(std::move(d[0]));
+            eraseAt(d, right->count, 0);
+            sep[i] = d[0];
+        } else {
+            innerNode* r = inner(right);
+            innerNode* x = inner(c);
+            ::new (static_cast<void*>(x->keys() + x->count))
+                    T(std::move(sep[i]));
+            x->children[x->count + 1] = r->children[0];
+            sep[i]                    = std::move(r->keys()[0]);
+            eraseAt(r->keys(), r->count, 0);
+            std::copy(r->children + 1, r->children + r->count + 1,
+                      r->children);
+        }
+        --right->count;
+        ++c->count;
+    } else if (left != nullptr) {
+        mergeChildren(parent, i - 1);
+    } else {
+        mergeChildren(parent, i);
+    }
+}
+
+template <class T, class Compare, size_t NodeBytes>
+void BTree<T, Compare, NodeBytes>::mergeChildren(innerNode* parent, size_t i) {
+    nodeBase* c     = parent->children[i];
+    nodeBase* right = parent->children[i + 1];
+    T*        sep   = parent->keys() + i;
+
+    if (c->leaf) {
+        leafNode* l = leaf(c);
+        leafNode* r = leaf(right);
+        detail::uninitializedRelocate(r->data(), r->data() + r->count,
+                                      l->data() + l->count);
+        destroy(r->data(), r->data() + r->count);
+        l->count += r->count;
+
+        l->next = r->next;
+        if (r->next != nullptr)
+            r->next->prev = l;
+        else
+            tail_ = l;
+        deleteLeaf(r);
+    } else {
+        innerNode* l = inner(c);
+        innerNode* r = inner(right);
+        ::new (static_cast<void*>(l->keys() + l->count)) T(std::move(*sep));
+        detail::uninitializedRelocate(r->keys(), r->keys() + r->count,
+                                      l->keys() + l->count + 1);
+        destroy(r->keys(), r->keys() + r->count);
+        std::copy(r->children, r->children + r->count + 1,
+                  l->children + l->count + 1);
+        l->count += r->count + 1;
+        deleteInner(r);
+    }
+
+    eraseAt(parent->keys(), parent->count, i);
+    std::copy(parent->children + i + 2, parent->children + parent->count + 1,
+              parent->children + i + 1);
+    --parent->count;
+}
+}    // namespace extrastl
+
+#endif
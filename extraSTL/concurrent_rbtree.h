@@ -0,0 +1,600 @@
+#ifndef EXTRASTL_CONCURRENT_RBTREE_H
+#define EXTRASTL_CONCURRENT_RBTREE_H
+
+#include "pool.h"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace extrastl {
+namespace detail {
+
+// concurrent_rbtree 的结点。结点发布（成为某个版本的一部分）之后不再修改，
+// 写者需要改动时先复制一份。
+template <class T>
+struct snapshotNode {
+    T             key;
+    snapshotNode* left;
+    snapshotNode* right;
+    size_t        size;       // 以该结点为根的子树的结点个数
+    uint64_t      version;    // 创建该结点的写操作的编号
+    bool          red;
+
+    template <class... Args>
+    explicit snapshotNode(uint64_t v, Args&&... args)
+            : key(std::forward<Args>(args)...), left(nullptr), right(nullptr),
+              size(1), version(v), red(true) {}
+};
+}    // namespace detail
+
+// 读多写少场景下的并发有序集合，键唯一。
+//
+// 读者用 take_snapshot() 取得某一时刻的不可变快照，查找与区间扫描都不加锁，
+// 也不会被写者阻塞。写者之间用互斥锁串行化：每次修改复制从根到修改位置的
+// 路径（path copying），再原子地替换根指针发布新版本。旧版本中被替换下来的
+// 结点按 epoch 回收，快照存在期间它能访问到的结点都不会被释放。
+//
+//     extrastl::concurrent_rbtree<int> index;
+//     index.insert(42);                            // 写者
+//     {
+//         auto snap = index.take_snapshot();       // 读者
+//         snap.range(10, 100, [](int k) { ... });  // [10, 100)
+//     }
+//
+// RBTree 的结点带有父指针，复制一个结点就要修改它所有孩子的父指针，
+// 无法做路径复制，因此这里使用不带父指针的左倾红黑树（LLRB），
+// 插入与删除都是自顶向下的递归，只会改动路径上的结点及其兄弟。
+//
+// 同时存在的快照最多 MAX_READERS 个，超出时 take_snapshot 自旋等待。
+// 长期持有快照会推迟所有旧结点的回收。析构时不能有未释放的快照。
+template <class T, class Compare = std::less<T>>
+class concurrent_rbtree {
+  private:
+    using node = detail::snapshotNode<T>;
+
+  public:
+    using value_type = T;
+    using size_type  = size_t;
+    using pool_type  = nodePool<node>;
+
+    static const size_t MAX_READERS = 128;
+
+    class snapshot;
+
+  private:
+    // 读者登记所在的 epoch，0 表示空闲。填充到 64 字节，避免伪共享。
+    struct readerSlot {
+        std::atomic<uint64_t> epoch;
+        char                  pad[64 - sizeof(std::atomic<uint64_t>)];
+    };
+    // 同一次写操作替换下来的结点，epoch 之后开始的读者都看不到它们
+    struct retiredBatch {
+        uint64_t           epoch;
+        std::vector<node*> nodes;
+    };
+
+    // LLRB 的高度不超过 2 log2(n + 1)
+    static const int MAX_HEIGHT = 128;
+
+    std::atomic<node*>    root_;
+    std::atomic<uint64_t> epoch_;
+    mutable readerSlot    slots_[MAX_READERS];
+    Compare               comp_;
+
+    // 以下成员只由持有 writeMutex_ 的写者访问
+    std::mutex               writeMutex_;
+    pool_type                pool_;
+    uint64_t                 version_;     // 当前写操作的编号
+    std::vector<node*>       created_;     // 本次写操作新建的结点
+    std::vector<node*>       retiring_;    // 本次写操作替换下来的结点
+    std::deque<retiredBatch> retired_;     // 等待读者离开后释放的结点
+
+  public:
+    // **************************************************************
+    // ************************构造函数*******************************
+    // **************************************************************
+    explicit concurrent_rbtree(const Compare& comp = Compare())
+            : root_(nullptr), epoch_(1), comp_(comp), version_(0) {
+        for (auto& s : slots_) s.epoch.store(0, std::memory_order_relaxed);
+    }
+    concurrent_rbtree(const concurrent_rbtree&) = delete;
+    concurrent_rbtree& operator=(const concurrent_rbtree&) = delete;
+    ~concurrent_rbtree() {
+        if (!std::is_trivially_destructible<T>::value) {
+            freeTree(root_.load(std::memory_order_relaxed));
+            for (auto& batch : retired_) {
+                for (node* x : batch.nodes) x->~node();
+            }
+        }
+        // 所有结点的内存随 pool_ 一起释放
+    }
+
+    // **************************************************************
+    // ***************************读者********************************
+    // **************************************************************
+
+    // 取得当前版本的快照，无锁。
+    snapshot take_snapshot() const {
+        readerSlot* slot = acquireSlot();
+        return snapshot(this, slot, root_.load());
+    }
+
+    template <class K>
+    bool contains(const K& k) const {
+        return take_snapshot().contains(k);
+    }
+    size_type size() const { return take_snapshot().size(); }
+
+    // **************************************************************
+    // ***************************写者********************************
+    // **************************************************************
+
+    // 键已存在时返回 false，不修改树。
+    bool insert(const T& key) { return insertImpl(key); }
+    bool insert(T&& key) { return insertImpl(std::move(key)); }
+
+    // 键不存在时返回 false。
+    template <class K>
+    bool erase(const K& key) {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        node* root = root_.load(std::memory_order_relaxed);
+        if (findNode(root, key) == nullptr) return false;
+
+        beginWrite();
+        try {
+            // 保证删除路径上的结点不是 2-结点
+            if (!isRed(root->left) && !isRed(root->right)) {
+                root      = mut(root);
+                root->red = true;
+            }
+            root = eraseNode(root, key);
+            if (root != nullptr) root->red = false;
+        } catch (...) {
+            abortWrite();
+            throw;
+        }
+        publish(root);
+        return true;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        beginWrite();
+        // 整棵旧树都被替换，全部交给 epoch 回收
+        node* stack[MAX_HEIGHT];
+        int   top = 0;
+        node* x   = root_.load(std::memory_order_relaxed);
+        while (x != nullptr || top != 0) {
+            if (x == nullptr) x = stack[--top];
+            retiring_.push_back(x);
+            if (x->right != nullptr) stack[top++] = x->right;
+            x = x->left;
+        }
+        publish(nullptr);
+    }
+
+  private:
+    // **************************************************************
+    // ***************************epoch 回收***************************
+    // **************************************************************
+
+    // 在 slots_ 中登记当前 epoch。登记后再读根指针：
+    // 写者若没看到这次登记，读者必然读到写者已经发布的新根。
+    readerSlot* acquireSlot() const {
+        const size_t start = std::hash<std::thread::id>()(
+                                     std::this_thread::get_id())
+                             % MAX_READERS;
+        for (;;) {
+            const uint64_t e = epoch_.load();
+            for (size_t i = 0; i != MAX_READERS; ++i) {
+                readerSlot& s        = slots_[(start + i) % MAX_READERS];
+                uint64_t    expected = 0;
+                if (s.epoch.load(std::memory_order_relaxed) == 0
+                    && s.epoch.compare_exchange_strong(expected, e)) {
+                    return &s;
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    void beginWrite() {
+        ++version_;
+        created_.clear();
+        retiring_.clear();
+    }
+
+    // 写操作中途抛出异常：新建的结点都未发布，直接释放，旧版本保持不变。
+    void abortWrite() {
+        for (node* x : created_) deleteNode(x);
+        created_.clear();
+        retiring_.clear();
+    }
+
+    // 发布新版本，替换下来的结点记为当前 epoch，然后推进 epoch。
+    // 此后登记的读者看到的都是新版本。
+    void publish(node* root) {
+        root_.store(root);
+        created_.clear();
+        if (!retiring_.empty()) {
+            retired_.emplace_back();
+            retired_.back().epoch = epoch_.load();
+            retired_.back().nodes.swap(retiring_);
+            epoch_.fetch_add(1);
+        }
+        reclaim();
+    }
+
+    // 释放所有活跃读者登记之前就已替换下来的结点
+    void reclaim() {
+        uint64_t minActive = UINT64_MAX;
+        for (auto& s : slots_) {
+            const uint64_t e = s.epoch.load();
+            if (e != 0 && e < minActive) minActive = e;
+        }
+        while (!retired_.empty() && retired_.front().epoch < minActive) {
+            for (node* x : retired_.front().nodes) deleteNode(x);
+            retired_.pop_front();
+        }
+    }
+
+    // **************************************************************
+    // ***************************结点********************************
+    // **************************************************************
+
+    template <class... Args>
+    node* newNode(Args&&... args) {
+        created_.reserve(created_.size() + 1);
+        node* x = pool_.allocate();
+        try {
+            ::new (static_cast<void*>(x))
+                    node(version_, std::forward<Args>(args)...);
+        } catch (...) {
+            pool_.deallocate(x);
+            throw;
+        }
+        created_.push_back(x);
+        return x;
+    }
+
+    void deleteNode(node* x) {
+        x->~node();
+        pool_.deallocate(x);
+    }
+
+    void freeTree(node* x) {
+        if (x == nullptr) return;
+        freeTree(x->left);
+        freeTree(x->right);
+        deleteNode(x);
+    }
+
+    // 返回 x 在本次写操作中可以修改的版本：x 已发布时复制一份，
+    // 原结点在发布新版本后交给 epoch 回收。
+    node* mut(node* x) {
+        if (x == nullptr || x->version == version_) return x;
+        retiring_.reserve(retiring_.size() + 1);
+        node* c  = newNode(x->key);
+        c->left  = x->left;
+        c->right = x->right;
+        c->size  = x->size;
+        c->red   = x->red;
+        retiring_.push_back(x);
+        return c;
+    }
+
+    // 从新版本中删去 x。x 可能是本次新建的结点，也一并延迟释放。
+    void retire(node* x) { retiring_.push_back(x); }
+
+    template <class K>
+    node* findNode(node* x, const K& k) const {
+        while (x != nullptr) {
+            if (comp_(k, x->key))
+                x = x->left;
+            else if (comp_(x->key, k))
+                x = x->right;
+            else
+                return x;
+        }
+        return nullptr;
+    }
+
+    // **************************************************************
+    // ***************************LLRB********************************
+    // **************************************************************
+    // 以下函数中作为参数 h 传入并被修改的结点都已经过 mut。
+
+    static bool   isRed(const node* x) { return x != nullptr && x->red; }
+    static size_t sizeOf(const node* x) { return x != nullptr ? x->size : 0; }
+    static void   updateSize(node* h) {
+        h->size = sizeOf(h->left) + sizeOf(h->right) + 1;
+    }
+
+    node* rotateLeft(node* h) {
+        node* x  = mut(h->right);
+        h->right = x->left;
+        x->left  = h;
+        x->red   = h->red;
+        h->red   = true;
+        x->size  = h->size;
+        updateSize(h);
+        return x;
+    }
+
+    node* rotateRight(node* h) {
+        node* x  = mut(h->left);
+        h->left  = x->right;
+        x->right = h;
+        x->red   = h->red;
+        h->red   = true;
+        x->size  = h->size;
+        updateSize(h);
+        return x;
+    }
+
+    void flipColors(node* h) {
+        h->left       = mut(h->left);
+        h->right      = mut(h->right);
+        h->red        = !h->red;
+        h->left->red  = !h->left->red;
+        h->right->red = !h->right->red;
+    }
+
+    // 恢复左倾红黑树的性质：红链接只能在左侧，不能有连续两条红链接
+    node* balance(node* h) {
+        if (isRed(h->right) && !isRed(h->left)) h = rotateLeft(h);
+        if (isRed(h->left) && isRed(h->left->left)) h = rotateRight(h);
+        if (isRed(h->left) && isRed(h->right)) flipColors(h);
+        updateSize(h);
+        return h;
+    }
+
+    template <class V>
+    bool insertImpl(V&& key) {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        node* root = root_.load(std::memory_order_relaxed);
+        if (findNode(root, key) != nullptr) return false;
+
+        beginWrite();
+        try {
+            root      = insertNode(root, std::forward<V>(key));
+            root->red = false;
+        } catch (...) {
+            abortWrite();
+            throw;
+        }
+        publish(root);
+        return true;
+    }
+
+    // 调用前已确认 key 不存在
+    template <class V>
+    node* insertNode(node* h, V&& key) {
+        if (h == nullptr) return newNode(std::forward<V>(key));
+        h = mut(h);
+        if (comp_(key, h->key))
+            h->left = insertNode(h->left, std::forward<V>(key));
+        else
+            h->right = insertNode(h->right, std::forward<V>(key));
+        return balance(h);
+    }
+
+    // 假设 h 为红色或 h->left 为红色，使 h->left 或其孩子之一变为红色
+    node* moveRedLeft(node* h) {
+        flipColors(h);
+        if (isRed(h->right->left)) {
+            h->right = rotateRight(mut(h->right));
+            h        = rotateLeft(h);
+            flipColors(h);
+        }
+        return h;
+    }
+
+    // 假设 h 为红色或 h->right 为红色，使 h->right 或其孩子之一变为红色
+    node* moveRedRight(node* h) {
+        flipColors(h);
+        if (isRed(h->left->left)) {
+            h = rotateRight(h);
+            flipColors(h);
+        }
+        return h;
+    }
+
+    static node* minNode(node* h) {
+        while (h->left != nullptr) h = h->left;
+        return h;
+    }
+
+    node* eraseMin(node* h) {
+        if (h->left == nullptr) {
+            retire(h);
+            return nullptr;
+        }
+        h = mut(h);
+        if (!isRed(h->left) && !isRed(h->left->left)) h = moveRedLeft(h);
+        h->left = eraseMin(h->left);
+        return balance(h);
+    }
+
+    // 调用前已确认 key 存在
+    template <class K>
+    node* eraseNode(node* h, const K& key) {
+        h = mut(h);
+        if (comp_(key, h->key)) {
+            if (!isRed(h->left) && !isRed(h->left->left)) h = moveRedLeft(h);
+            h->left = eraseNode(h->left, key);
+        } else {
+            if (isRed(h->left)) h = rotateRight(h);
+            if (!comp_(h->key, key) && h->right == nullptr) {
+                retire(h);
+                return nullptr;
+            }
+            if (!isRed(h->right) && !isRed(h->right->left)) {
+                h = moveRedRight(h);
+            }
+            if (!comp_(h->key, key)) {
+                // 用后继的键构造新结点取代 h，结点的键不需要可赋值
+                node* n  = newNode(minNode(h->right)->key);
+                n->left  = h->left;
+                n->right = h->right;
+                n->red   = h->red;
+                retire(h);
+                h        = n;
+                h->right = eraseMin(h->right);
+            } else {
+                h->right = eraseNode(h->right, key);
+            }
+        }
+        return balance(h);
+    }
+
+  public:
+    // 某一时刻的只读视图。持有期间它能访问到的结点都不会被释放，
+    // 返回的元素指针在快照析构或 release 之前有效。
+    // 同一个快照不能被多个线程同时使用。
+    class snapshot {
+        friend class concurrent_rbtree;
+
+        readerSlot* slot_;
+        const node* root_;
+        Compare     comp_;
+
+        snapshot(const concurrent_rbtree* tree, readerSlot* slot,
+                 const node* root)
+                : slot_(slot), root_(root), comp_(tree->comp_) {}
+
+      public:
+        snapshot(snapshot&& s)
+                : slot_(s.slot_), root_(s.root_), comp_(s.comp_) {
+            s.slot_ = nullptr;
+            s.root_ = nullptr;
+        }
+        snapshot(const snapshot&) = delete;
+        snapshot& operator=(const snapshot&) = delete;
+        ~snapshot() { release(); }
+
+        // 提前结束快照，之后快照为空
+        void release() {
+            if (slot_ != nullptr) slot_->epoch.store(0);
+            slot_ = nullptr;
+            root_ = nullptr;
+        }
+
+        bool      empty() const { return root_ == nullptr; }
+        size_type size() const { return sizeOf(root_); }
+
+        // 与 k 等价的元素，不存在时返回 nullptr
+        template <class K>
+        const T* find(const K& k) const {
+            const node* x = root_;
+            while (x != nullptr) {
+                if (comp_(k, x->key))
+                    x = x->left;
+                else if (comp_(x->key, k))
+                    x = x->right;
+                else
+                    return &x->key;
+            }
+            return nullptr;
+        }
+        template <class K>
+        bool contains(const K& k) const {
+            return find(k) != nullptr;
+        }
+
+        // 第一个不小于 k 的元素，不存在时返回 nullptr
+        template <class K>
+        const T* lower_bound(const K& k) const {
+            const node* x   = root_;
+            const node* res = nullptr;
+            while (x != nullptr) {
+                if (comp_(x->key, k)) {
+                    x = x->right;
+                } else {
+                    res = x;
+                    x   = x->left;
+                }
+            }
+            return res != nullptr ? &res->key : nullptr;
+        }
+
+        // 第 k 小（从 0 开始计）的元素，k >= size() 时返回 nullptr
+        const T* select(size_type k) const {
+            const node* x = root_;
+            while (x != nullptr) {
+                const size_t l = sizeOf(x->left);
+                if (k < l) {
+                    x = x->left;
+                } else if (k == l) {
+                    return &x->key;
+                } else {
+                    k -= l + 1;
+                    x = x->right;
+                }
+            }
+            return nullptr;
+        }
+
+        // 小于 k 的元素个数
+        template <class K>
+        size_type rank(const K& k) const {
+            const node* x = root_;
+            size_type   r = 0;
+            while (x != nullptr) {
+                if (comp_(x->key, k)) {
+                    r += sizeOf(x->left) + 1;
+                    x = x->right;
+                } else {
+                    x = x->left;
+                }
+            }
+            return r;
+        }
+
+        // 按升序对 [lo, hi) 中的每个元素调用 f，用显式栈做中序遍历。
+        template <class K1, class K2, class F>
+        void range(const K1& lo, const K2& hi, F f) const {
+            const node* stack[MAX_HEIGHT];
+            int         top = 0;
+            for (const node* x = root_; x != nullptr;) {
+                if (comp_(x->key, lo)) {
+                    x = x->right;
+                } else {
+                    stack[top++] = x;
+                    x            = x->left;
+                }
+            }
+            while (top != 0) {
+                const node* x = stack[--top];
+                if (!comp_(x->key, hi)) return;
+                f(x->key);
+                for (x = x->right; x != nullptr; x = x->left) stack[top++] = x;
+            }
+        }
+
+        // 按升序对每个元素调用 f
+        template <class F>
+        void for_each(F f) const {
+            const node* stack[MAX_HEIGHT];
+            int         top = 0;
+            for (const node* x = root_; x != nullptr; x = x->left) {
+                stack[top++] = x;
+            }
+            while (top != 0) {
+                const node* x = stack[--top];
+                f(x->key);
+                for (x = x->right; x != nullptr; x = x->left) stack[top++] = x;
+            }
+        }
+    };
+};
+}    // namespace extrastl
+
+#endif
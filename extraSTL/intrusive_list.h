@@ -0,0 +1,357 @@
+#ifndef EXTRASTL_INTRUSIVE_LIST_H
+#define EXTRASTL_INTRUSIVE_LIST_H
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace extrastl {
+
+// 嵌入到元素结构体中的链表钩子。
+// 复制元素时不复制钩子，副本处于未链接状态。
+struct intrusive_list_hook {
+    intrusive_list_hook* prev;
+    intrusive_list_hook* next;
+
+    intrusive_list_hook() : prev(nullptr), next(nullptr) {}
+    intrusive_list_hook(const intrusive_list_hook&)
+            : prev(nullptr), next(nullptr) {}
+    intrusive_list_hook& operator=(const intrusive_list_hook&) {
+        return *this;
+    }
+    // 元素析构前必须先从链表中删除。
+    ~intrusive_list_hook() { assert(!is_linked()); }
+
+    bool is_linked() const { return next != nullptr; }
+};
+
+template <class T, intrusive_list_hook T::*Hook>
+class intrusive_list;
+
+namespace detail {
+
+// 由钩子的地址反推所在元素的地址。
+template <class T, intrusive_list_hook T::*Hook>
+struct intrusiveHookTraits {
+    static size_t offset() {
+        static const size_t value = [] {
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type buf;
+            const T* t = reinterpret_cast<const T*>(&buf);
+            return static_cast<size_t>(
+                    reinterpret_cast<const char*>(&(t->*Hook))
+                    - reinterpret_cast<const char*>(t));
+        }();
+        return value;
+    }
+    static T* toValue(intrusive_list_hook* h) {
+        return reinterpret_cast<T*>(reinterpret_cast<char*>(h) - offset());
+    }
+};
+
+// intrusive_list 迭代器，Value 为 const T 时是 const_iterator。
+template <class T, intrusive_list_hook T::*Hook, class Value>
+struct intrusiveListIterator {
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type        = typename std::remove_const<Value>::type;
+    using difference_type   = ptrdiff_t;
+    using pointer           = Value*;
+    using reference         = Value&;
+
+    intrusive_list_hook* p;
+
+    explicit intrusiveListIterator(intrusive_list_hook* ptr = nullptr)
+            : p(ptr) {}
+    // iterator 可以隐式转换为 const_iterator。
+    template <class U, class = typename std::enable_if<
+                               std::is_same<const U, Value>::value
+                               && !std::is_same<U, Value>::value>::type>
+    intrusiveListIterator(const intrusiveListIterator<T, Hook, U>& other)
+            : p(other.p) {}
+
+    intrusiveListIterator& operator++() {
+        p = p->next;
+        return *this;
+    }
+    intrusiveListIterator operator++(int) {
+        auto res = *this;
+        ++*this;
+        return res;
+    }
+    intrusiveListIterator& operator--() {
+        p = p->prev;
+        return *this;
+    }
+    intrusiveListIterator operator--(int) {
+        auto res = *this;
+        --*this;
+        return res;
+    }
+    bool operator==(const intrusiveListIterator& other) const {
+        return p == other.p;
+    }
+    bool operator!=(const intrusiveListIterator& other) const {
+        return !(*this == other);
+    }
+
+    Value& operator*() const {
+        return *intrusiveHookTraits<T, Hook>::toValue(p);
+    }
+    Value* operator->() const { return &(operator*()); }
+};
+}    // namespace detail
+
+// 侵入式双向链表：链表指针存放在元素自身的 intrusive_list_hook 成员中，
+// 插入、删除都不分配内存。元素的生命周期由使用者管理，链表只负责链接：
+//
+//     struct timer {
+//         int                           deadline;
+//         extrastl::intrusive_list_hook hook;
+//     };
+//     extrastl::intrusive_list<timer, &timer::hook> timers;
+//     timers.push_back(t);
+//     timers.erase(t);    // O(1)，不需要先找到迭代器
+//
+// 迭代器、splice、merge、sort 的语义与 extrastl::list 相同，
+// 由于不存在节点池，splice 与 merge 对两个链表没有额外要求。
+// 一个钩子同一时刻只能位于一个链表中，同时挂在多个链表上的元素需要多个钩子。
+// 链表析构或 clear 时只解除链接，不析构元素。
+template <class T, intrusive_list_hook T::*Hook>
+class intrusive_list {
+  private:
+    using hook = intrusive_list_hook;
+
+  public:
+    using value_type      = T;
+    using iterator        = detail::intrusiveListIterator<T, Hook, T>;
+    using const_iterator  = detail::intrusiveListIterator<T, Hook, const T>;
+    using reference       = T&;
+    using const_reference = const T&;
+    using size_type       = size_t;
+
+  private:
+    // 环形链表的哨兵，next 指向第一个元素，prev 指向最后一个元素。
+    hook      sentinel_;
+    size_type size_;
+
+  public:
+    // **************************************************************
+    // ************************构造函数*******************************
+    // **************************************************************
+    intrusive_list() : size_(0) {
+        sentinel_.prev = sentinel_.next = &sentinel_;
+    }
+    intrusive_list(const intrusive_list&) = delete;
+    intrusive_list& operator=(const intrusive_list&) = delete;
+    intrusive_list(intrusive_list&& l) : intrusive_list() { swap(l); }
+    intrusive_list& operator=(intrusive_list&& l) {
+        if (this != &l) {
+            clear();
+            swap(l);
+        }
+        return *this;
+    }
+    ~intrusive_list() {
+        clear();
+        sentinel_.prev = sentinel_.next = nullptr;
+    }
+
+    // **************************************************************
+    // ************************元素访问*******************************
+    // **************************************************************
+    reference front() { return *begin(); }
+    reference back() { return *--end(); }
+
+    // **************************************************************
+    // ***************************容量********************************
+    // **************************************************************
+    bool      empty() const { return sentinel_.next == &sentinel_; }
+    size_type size() const { return size_; }
+
+    // **************************************************************
+    // ***************************修改********************************
+    // **************************************************************
+    void push_front(T& value) { insert(begin(), value); }
+    void popfront() { erase(begin()); }
+    void push_back(T& value) { insert(end(), value); }
+    void popback() { erase(--end()); }
+
+    // 将 value 链接到 position 之前，value 不能已经位于某个链表中。
+    iterator insert(const_iterator position, T& value) {
+        hook* h = &(value.*Hook);
+        assert(!h->is_linked());
+        linkBefore(position.p, h);
+        ++size_;
+        return iterator(h);
+    }
+
+    iterator erase(const_iterator position) {
+        hook* next = position.p->next;
+        unlink(position.p);
+        --size_;
+        return iterator(next);
+    }
+    iterator erase(const_iterator first, const_iterator last) {
+        while (first != last) first = erase(first);
+        return iterator(last.p);
+    }
+    // 从链表中删除 value，value 必须位于本链表中。
+    void erase(T& value) { erase(iterator_to(value)); }
+
+    // 解除所有元素的链接，O(n)。
+    void clear() {
+        while (!empty()) popfront();
+    }
+
+    // 交换两个链表的内容，需要修正首尾元素指向哨兵的指针。
+    void swap(intrusive_list& x) {
+        std::swap(sentinel_.prev, x.sentinel_.prev);
+        std::swap(sentinel_.next, x.sentinel_.next);
+        std::swap(size_, x.size_);
+        fixSentinel(&x.sentinel_);
+        x.fixSentinel(&sentinel_);
+    }
+
+    // **************************************************************
+    // ***************************迭代器********************************
+    // **************************************************************
+    iterator       begin() { return iterator(sentinel_.next); }
+    iterator       end() { return iterator(&sentinel_); }
+    const_iterator begin() const { return const_iterator(sentinel_.next); }
+    const_iterator end() const {
+        return const_iterator(const_cast<hook*>(&sentinel_));
+    }
+
+    // 返回指向 value 的迭代器，value 必须位于本链表中。O(1)。
+    iterator       iterator_to(T& value) { return iterator(&(value.*Hook)); }
+    const_iterator iterator_to(const T& value) const {
+        return const_iterator(const_cast<hook*>(&(value.*Hook)));
+    }
+
+    // **************************************************************
+    // ***************************操作********************************
+    // **************************************************************
+
+    // 将 x 的全部元素移到 position 之前，O(1)。
+    void splice(const_iterator position, intrusive_list& x) {
+        if (x.empty()) return;
+        transfer(position, x.begin(), x.end());
+        size_ += x.size_;
+        x.size_ = 0;
+    }
+
+    // 将 x 的 [first, last) 移到 position 之前。
+    // x 不是 *this 时需要统计区间长度，为 O(last - first)。
+    void splice(const_iterator position, intrusive_list& x,
+                const_iterator first, const_iterator last) {
+        if (first == last) return;
+        if (&x != this) {
+            const auto n = static_cast<size_type>(std::distance(first, last));
+            size_ += n;
+            x.size_ -= n;
+        }
+        transfer(position, first, last);
+    }
+
+    void splice(const_iterator position, intrusive_list& x,
+                const_iterator i) {
+        auto next = i;
+        ++next;
+        if (position == i || position == next) return;
+        if (&x != this) {
+            ++size_;
+            --x.size_;
+        }
+        transfer(position, i, next);
+    }
+
+    void merge(intrusive_list& x) { merge(x, std::less<T>()); }
+
+    template <class Compare>
+    void merge(intrusive_list& x, Compare comp) {
+        auto it1 = begin(), it2 = x.begin();
+        while (it1 != end() && it2 != x.end()) {
+            if (comp(*it2, *it1)) {
+                auto temp = it2++;
+                this->splice(it1, x, temp);
+            } else
+                ++it1;
+        }
+        if (it1 == end()) { this->splice(it1, x, it2, x.end()); }
+    }
+
+    void sort() { sort(std::less<T>()); }
+
+    // 与 list::sort 相同的自底向上归并排序，稳定，不分配内存。
+    template <class Compare>
+    void sort(Compare comp) {
+        if (size_ < 2) return;
+        intrusive_list carry;
+        intrusive_list counter[64];
+        int            fill = 0;
+        while (!empty()) {
+            carry.splice(carry.begin(), *this, begin());
+            int i = 0;
+            while (i < fill && !counter[i].empty()) {
+                counter[i].merge(carry, comp);
+                carry.swap(counter[i++]);
+            }
+            carry.swap(counter[i]);
+            if (i == fill) ++fill;
+        }
+        for (int i = 1; i != fill; ++i) {
+            counter[i].merge(counter[i - 1], comp);
+        }
+        swap(counter[fill - 1]);
+    }
+
+  private:
+    static void linkBefore(hook* position, hook* h) {
+        h->next              = position;
+        h->prev              = position->prev;
+        position->prev->next = h;
+        position->prev       = h;
+    }
+
+    static void unlink(hook* h) {
+        h->prev->next = h->next;
+        h->next->prev = h->prev;
+        h->prev = h->next = nullptr;
+    }
+
+    // 将非空区间 [first, last) 摘下并接到 position 之前，不修改 size_。
+    static void transfer(const_iterator position, const_iterator first,
+                         const_iterator last) {
+        if (position == first || position == last) return;
+        hook* f = first.p;
+        hook* l = last.p->prev;
+        // 从原位置摘下
+        f->prev->next = last.p;
+        last.p->prev  = f->prev;
+        // 接到 position 之前
+        f->prev                = position.p->prev;
+        l->next                = position.p;
+        position.p->prev->next = f;
+        position.p->prev       = l;
+    }
+
+    // swap 之后，把仍指向 oldSentinel 的首尾元素改为指向自身的哨兵。
+    void fixSentinel(hook* oldSentinel) {
+        if (sentinel_.next == oldSentinel) {
+            sentinel_.prev = sentinel_.next = &sentinel_;
+        } else {
+            sentinel_.next->prev = &sentinel_;
+            sentinel_.prev->next = &sentinel_;
+        }
+    }
+};
+
+template <class T, intrusive_list_hook T::*Hook>
+void swap(intrusive_list<T, Hook>& x, intrusive_list<T, Hook>& y) {
+    x.swap(y);
+}
+}    // namespace extrastl
+
+#endif
@@ -1,25 +1,58 @@
 #ifndef EXTRASTL_LIST_H_
 #define EXTRASTL_LIST_H_
 
+#include "algorithm.h"
+#include "pool.h"
+
+#include <algorithm>
 #include <memory>
 #include <iterator>
 #include <list>
+#include <type_traits>
+#include <utility>
+#include <vector>
 namespace extrastl {
 namespace detail {
+// 链表节点的链接部分，哨兵节点只有这一部分。
+struct listNodeBase {
+    listNodeBase* prev;
+    listNodeBase* next;
+    listNodeBase() : prev(nullptr), next(nullptr) {}
+};
+
+// 链表节点结构
 template <class T>
-struct node;
+struct node : listNodeBase {
+    T data;
+    template <class... Args>
+    explicit node(Args&&... args) : data(std::forward<Args>(args)...) {}
+};
+
 template <class T>
 struct listIterator;
-}
+}    // namespace detail
 
 //the class of list
+//
+// 节点从 nodePool 中分配。默认每个 list 有自己的节点池，析构时整块归还内存；
+// 也可以在构造时传入节点池，让多个 list 共用：
+//
+//     auto pool = std::make_shared<extrastl::list<int>::pool_type>();
+//     extrastl::list<int> a(pool), b(pool);
+//
+// 节点池非线程安全，共用节点池的 list 不能在不同线程中同时修改。
+//
+// splice、merge 在两个 list 的节点池不同时仍然只修改指针：使用自己节点池的
+// list 会持有对方节点池的引用，使拼接过来的节点在本链表析构前一直有效，
+// 这些节点释放后归还到本链表的节点池中。传入了节点池的 list 与其他 list
+// 共用节点池，不能这样借用，此时改为把元素逐个移动构造到自己的节点池中。
 template <class T>
 class list {
     friend struct detail::listIterator<T>;
 
   private:
-    using nodeAllocator = std::allocator<detail::node<T>>;
-    using nodePtr       = detail::node<T>*;
+    using nodeBase = detail::listNodeBase;
+    using nodeType = detail::node<T>;
 
   public:
     using value_type     = T;
@@ -27,149 +60,148 @@ class list {
     using const_iterator = detail::listIterator<const T>;
     using reference      = T&;
     using size_type      = size_t;
+    using pool_type      = nodePool<nodeType>;
 
   private:
-    iterator head;
-    iterator tail;
+    // head.p 指向第一个节点（prev 为 nullptr），空链表时指向哨兵。
+    // 哨兵是链表对象的成员，只有 prev、next 两个指针，不含元素，
+    // prev 指向最后一个节点。移动、交换链表时需要重新链接首尾。
+    iterator                   head;
+    nodeBase                   sentinel_;
+    std::shared_ptr<pool_type> pool_;    // 为空时在第一次分配节点时创建
+    // 拼接进来的节点所属的其他节点池，在本链表析构前保持存活
+    std::vector<std::shared_ptr<pool_type>> borrowed_;
+    size_type                               size_;    // 元素个数
+    bool ownPool_;    // pool_ 由本链表独占，可以接收其他节点池的节点
 
   public:
     // **************************************************************
     // ************************构造函数*******************************
     // **************************************************************
-    list() {
-        head.p = newNode();
-        tail.p = head.p;
-    }
-    explicit list(size_type n, const value_type& val = value_type()) {
-        ctorAux(n, val, std::is_integral<value_type>());
+    // 不分配内存，节点池在插入第一个元素时创建。
+    list() noexcept : list(std::shared_ptr<pool_type>()) {}
+    // pool 为空时与默认构造相同，使用自己的节点池。
+    explicit list(std::shared_ptr<pool_type> pool) noexcept
+            : head(&sentinel_), pool_(std::move(pool)), size_(0),
+              ownPool_(pool_ == nullptr) {}
+    explicit list(size_type n, const value_type& val = value_type()) : list() {
+        insert(end(), n, val);
     }
     template <class InputIterator>
-    list(InputIterator first, InputIterator last) {
-        ctorAux(first, last, std::is_integral<InputIterator>());
-    }
-    list(const list& l) {
-        head.p = newNode();
-        tail.p = head.p;
-        for (auto node = l.head.p; node != l.tail.p; node = node->next)
-            push_back(node->data);
-    }
+    list(InputIterator first, InputIterator last) : list() {
+        insert(end(), first, last);
+    }
+    list(const list& l) : list() { insert(end(), l.begin(), l.end()); }
+    // 接管 l 的全部节点与节点池，不分配内存。
+    // l 变为空链表，与默认构造的链表相同。
+    list(list&& l) noexcept : list() { swap(l); }
+    // 赋值后仍使用自身原来的节点池。
     list& operator=(const list& l) {
-        if (this != &l) { list(l).swap(*this); }
+        if (this != &l) {
+            list temp(pool());
+            temp.insert(temp.end(), l.begin(), l.end());
+            swapNodes(temp);
+        }
+        return *this;
+    }
+    // 节点池随元素一起转移，相当于分配器的
+    // propagate_on_container_move_assignment 为 true。
+    list& operator=(list&& l) noexcept {
+        if (this != &l) {
+            list temp(std::move(l));
+            swap(temp);
+        }
         return *this;
     }
     ~list() {
-        nodeAllocator alloc;
-        for (; head != tail;) {
-            auto          temp = head++;
-            nodeAllocator alloc;
-            alloc.destroy(temp.p);
-            alloc.deallocate(temp.p, 1);
+        for (; head.p != &sentinel_;) {
+            auto temp = head++;
+            deleteNode(temp.p);
         }
-        alloc.deallocate(tail.p, 1);
     }
 
     // **************************************************************
     // ************************元素访问*******************************
     // **************************************************************
-    reference front() { return (head.p->data); }
-    reference back() { return (tail.p->prev->data); }
+    reference front() { return *begin(); }
+    reference back() { return *--end(); }
 
     // **************************************************************
     // ***************************容量********************************
     // **************************************************************
-    bool      empty() const { return head == tail; }
-    size_type size() const {
-        size_type length = 0;
-        for (auto h = head; h != tail; ++h) ++length;
-        return length;
-    };
+    bool      empty() const { return head.p == &sentinel_; }
+    size_type size() const { return size_; }
 
     // **************************************************************
     // ***************************修改********************************
     // **************************************************************
 
-    void push_front(const value_type& val) {
-        auto node    = newNode(val);
-        head.p->prev = node;
-        node->next   = head.p;
-        head.p       = node;
-    }
-
-    void popfront() {
-        auto oldNode = head.p;
-        head.p       = oldNode->next;
-        head.p->prev = nullptr;
-        deleteNode(oldNode);
-    }
-
-    void push_back(const value_type& val) {
-        auto node      = newNode();
-        (tail.p)->data = val;
-        (tail.p)->next = node;
-        node->prev     = tail.p;
-        tail.p         = node;
-    }
-
-    void popback() {
-        auto newTail  = tail.p->prev;
-        newTail->next = nullptr;
-        deleteNode(tail.p);
-        tail.p = newTail;
-    }
-    iterator insert(iterator position, const value_type& val) {
-        if (position == begin()) {
-            push_front(val);
-            return begin();
-        } else if (position == end()) {
-            auto ret = position;
-            push_back(val);
-            return ret;
-        }
-        auto node        = newNode(val);
-        auto prev        = position.p->prev;
-        node->next       = position.p;
-        node->prev       = prev;
-        prev->next       = node;
-        position.p->prev = node;
+    void push_front(const value_type& val) { emplace_front(val); }
+    void push_front(value_type&& val) { emplace_front(std::move(val)); }
+
+    template <class... Args>
+    reference emplace_front(Args&&... args) {
+        return *emplace(begin(), std::forward<Args>(args)...);
+    }
+
+    void popfront() { erase(begin()); }
+
+    void push_back(const value_type& val) { emplace_back(val); }
+    void push_back(value_type&& val) { emplace_back(std::move(val)); }
+
+    template <class... Args>
+    reference emplace_back(Args&&... args) {
+        return *emplace(end(), std::forward<Args>(args)...);
+    }
+
+    void popback() { erase(--end()); }
+
+    // 在 position 之前原地构造元素，返回指向新元素的迭代器。
+    template <class... Args>
+    iterator emplace(const_iterator position, Args&&... args) {
+        nodeBase* node = newNode(std::forward<Args>(args)...);
+        linkBefore(position.p, node);
+        ++size_;
         return iterator(node);
     }
 
-    void insert(iterator position, size_type n, const value_type& val) {
+    iterator insert(const_iterator position, const value_type& val) {
+        return emplace(position, val);
+    }
+    iterator insert(const_iterator position, value_type&& val) {
+        return emplace(position, std::move(val));
+    }
+
+    void insert(const_iterator position, size_type n, const value_type& val) {
         insert_aux(position, n, val,
                    typename std::is_integral<size_type>::type());
     }
 
     template <class InputIterator>
-    void insert(iterator position, InputIterator first, InputIterator last) {
+    void insert(const_iterator position, InputIterator first,
+                InputIterator last) {
         insert_aux(position, first, last,
                    typename std::is_integral<InputIterator>::type());
     }
-    iterator erase(iterator position) {
-        if (position == head) {
-            popfront();
-            return head;
-        } else {
-            auto prev              = position.p->prev;
-            prev->next             = position.p->next;
-            position.p->next->prev = prev;
-            deleteNode(position.p);
-            return iterator(prev->next);
-        }
+    iterator erase(const_iterator position) {
+        nodeBase* next = position.p->next;
+        unlink(position.p);
+        deleteNode(position.p);
+        --size_;
+        return iterator(next);
     }
-    iterator erase(iterator first, iterator last) {
-        typename list<T>::iterator res;
-        for (; first != last;) {
-            auto temp = first++;
-            res       = erase(temp);
-        }
-        return res;
+    iterator erase(const_iterator first, const_iterator last) {
+        while (first != last) first = erase(first);
+        return iterator(last.p);
     }
 
     void clear() { erase(begin(), end()); }
 
-    void swap(list& x) {
-        std::swap(head.p, x.head.p);
-        std::swap(tail.p, x.tail.p);
+    void swap(list& x) noexcept {
+        swapNodes(x);
+        pool_.swap(x.pool_);
+        borrowed_.swap(x.borrowed_);
+        std::swap(ownPool_, x.ownPool_);
     }
 
     // **************************************************************
@@ -184,73 +216,76 @@ class list {
     // ***************************操作********************************
     // **************************************************************
 
+    // 将 x 的全部元素移到 position 之前，只修改指针，O(1)。
+    // 不能借用 x 的节点池时为 O(x.size())，见类的说明。
     void splice(iterator position, list& x) {
-        this->insert(position, x.begin(), x.end());
-        x.head.p = x.tail.p;
+        if (x.empty()) return;
+        if (!borrowPools(x)) {
+            moveElements(position, x, x.begin(), x.end());
+            return;
+        }
+        transfer(position, x, x.begin(), x.end());
+        size_ += x.size_;
+        x.size_ = 0;
     }
 
+    // 将 x 的 [first, last) 移到 position 之前。
+    // x 不是 *this 时需要统计区间长度，为 O(last - first)。
     void splice(iterator position, list& x, iterator first, iterator last) {
         if (first.p == last.p) return;
-        auto tailNode = last.p->prev;
-        if (x.head.p == first.p) {
-            x.head.p       = last.p;
-            x.head.p->prev = nullptr;
-        } else {
-            first.p->prev->next = last.p;
-            last.p->prev        = first.p->prev;
-        }
-        if (position.p == head.p) {
-            first.p->prev  = nullptr;
-            tailNode->next = head.p;
-            head.p->prev   = tailNode;
-            head.p         = first.p;
-        } else {
-            position.p->prev->next = first.p;
-            first.p->prev          = position.p->prev;
-            tailNode->next         = position.p;
-            position.p->prev       = tailNode;
+        if (!borrowPools(x)) {
+            moveElements(position, x, first, last);
+            return;
         }
+        transferRange(position, x, first, last);
     }
 
     void splice(iterator position, list& x, iterator i) {
         auto next = i;
-        this->splice(position, x, i, ++next);
+        ++next;
+        if (position == i || position == next) return;
+        if (!borrowPools(x)) {
+            moveElements(position, x, i, next);
+            return;
+        }
+        transferOne(position, x, i);
     }
 
+    // x 的元素 e 只有在 !(p <= e) 时才排到本链表的元素 p 之前
     void merge(list& x) {
-        auto it1 = begin(), it2 = x.begin();
-        while (it1 != end() && it2 != x.end()) {
-            if (*it1 <= *it2)
-                ++it1;
-            else {
-                auto temp = it2++;
-                this->splice(it1, x, temp);
-            }
-        }
-        if (it1 == end()) { this->splice(it1, x, it2, x.end()); }
+        merge(x, [](const T& e, const T& p) { return !(p <= e); });
     }
 
+    // 节点池只借用一次，之后逐个拼接节点
     template <class Compare>
     void merge(list& x, Compare comp) {
+        if (&x == this || x.empty()) return;
+        if (!borrowPools(x)) {
+            list temp(pool());
+            temp.moveElements(temp.end(), x, x.begin(), x.end());
+            merge(temp, comp);
+            return;
+        }
         auto it1 = begin(), it2 = x.begin();
         while (it1 != end() && it2 != x.end()) {
             if (comp(*it2, *it1)) {
                 auto temp = it2++;
-                this->splice(it1, x, temp);
+                transferOne(it1, x, temp);
             } else
                 ++it1;
         }
-        if (it1 == end()) { this->splice(it1, x, it2, x.end()); }
+        if (it1 == end()) transferRange(it1, x, it2, x.end());
     }
 
     void sort() { sort(std::less<T>()); }
 
     template <class Compare>
     void sort(Compare comp) {
-        if (empty() || head.p->next == tail.p) return;
-        list carry;
+        if (empty() || head.p->next == &sentinel_) return;
+        list carry(pool());
         list counter[64];
-        int  fill = 0;
+        for (auto& c : counter) c.usePool(pool_);
+        int fill = 0;
         while (!empty()) {
             carry.splice(carry.begin(), *this, begin());
             int i = 0;
@@ -261,66 +296,338 @@ class list {
             carry.swap(counter[i]);
             if (i == fill) ++fill;
         }
-        for (int i = 0; i != fill; ++i) {
+        for (int i = 1; i != fill; ++i) {
             counter[i].merge(counter[i - 1], comp);
         }
-        swap(counter[fill - 1]);
+        swapNodes(counter[fill - 1]);
+    }
+
+    void parallel_sort() { parallel_sort(std::less<T>()); }
+
+    // 多线程排序，结果与 sort 相同：稳定，只重新链接节点，
+    // 迭代器仍指向原来的元素。元素较少时直接调用 sort。
+    // comp 会被多个线程同时调用。
+    //
+    // 可平凡复制的元素连同节点指针复制到连续的缓冲区中排序，再按结果重新链接，
+    // 避免归并时在冷节点之间来回跳转；其余元素把链表切成若干段，
+    // 各线程分别归并排序，再并行地两两归并。
+    template <class Compare>
+    void parallel_sort(Compare comp) {
+        if (parallel::detail::chunkCount(size_) <= 1) {
+            sort(comp);
+            return;
+        }
+        parallelSortAux(comp, typename std::is_trivially_copyable<T>::type());
     }
 
   private:
-    void ctorAux(size_type n, const value_type& val, std::true_type) {
-        head.p = newNode();    //add a dummy node
-        tail.p = head.p;
-        while (n--) push_back(val);
+    static T& value(nodeBase* p) { return static_cast<nodeType*>(p)->data; }
+
+    // 只交换两个链表的节点，节点池不变，两者必须使用同一个节点池。
+    void swapNodes(list& x) noexcept {
+        nodeBase*       first = empty() ? nullptr : head.p;
+        nodeBase*       last  = sentinel_.prev;
+        const size_type n     = size_;
+        setNodes(x.empty() ? nullptr : x.head.p, x.sentinel_.prev, x.size_);
+        x.setNodes(first, last, n);
+    }
+    // 以 [first, last] 这 n 个已链接好的节点作为链表的全部节点，
+    // first 为 nullptr 时链表为空。
+    void setNodes(nodeBase* first, nodeBase* last, size_type n) noexcept {
+        size_ = n;
+        if (first == nullptr) {
+            head.p         = &sentinel_;
+            sentinel_.prev = nullptr;
+        } else {
+            head.p         = first;
+            last->next     = &sentinel_;
+            sentinel_.prev = last;
+        }
     }
-    template <class InputIterator>
-    void ctorAux(InputIterator first, InputIterator last, std::false_type) {
-        head.p = newNode();    //add a dummy node
-        tail.p = head.p;
-        for (; first != last; ++first) push_back(*first);
-    }
-    nodePtr newNode(const T& val = T()) {
-        nodeAllocator alloc;
-        nodePtr       res = alloc.allocate(1);
-        alloc.construct(res, detail::node<T>(val, nullptr, nullptr, this));
+
+    // 使 x 的节点可以直接链接到本链表中：本链表借用 x 的节点池以及 x 借用的
+    // 节点池，保持它们存活。本链表与其他链表共用节点池时不能借用，返回 false。
+    bool borrowPools(const list& x) {
+        bool missing = !hasPool(x.pool_);
+        for (auto& p : x.borrowed_) missing = missing || !hasPool(p);
+        if (!missing) return true;
+        if (!ownPool_) return false;
+
+        if (!hasPool(x.pool_)) borrowed_.push_back(x.pool_);
+        for (auto& p : x.borrowed_) {
+            if (!hasPool(p)) borrowed_.push_back(p);
+        }
+        return true;
+    }
+    bool hasPool(const std::shared_ptr<pool_type>& p) const {
+        return p == nullptr || p == pool_
+               || std::find(borrowed_.begin(), borrowed_.end(), p)
+                          != borrowed_.end();
+    }
+
+    // 不能借用节点池时的 splice：把 x 的 [first, last) 逐个移动构造到
+    // position 之前，并从 x 中删除。
+    void moveElements(iterator position, list& x, iterator first,
+                      iterator last) {
+        while (first != last) {
+            emplace(position, std::move(*first));
+            first = x.erase(first);
+        }
+    }
+
+    // 将 x 的 [first, last) 或 i 移到 position 之前并更新元素个数，
+    // 调用前节点池已经借用。
+    void transferRange(iterator position, list& x, iterator first,
+                       iterator last) {
+        if (&x != this) {
+            const auto n = static_cast<size_type>(std::distance(first, last));
+            size_ += n;
+            x.size_ -= n;
+        }
+        transfer(position, x, first, last);
+    }
+    void transferOne(iterator position, list& x, iterator i) {
+        auto next = i;
+        ++next;
+        if (position == i || position == next) return;
+        if (&x != this) {
+            ++size_;
+            --x.size_;
+        }
+        transfer(position, x, i, next);
+    }
+
+    template <class Compare>
+    void parallelSortAux(Compare comp, std::true_type) {
+        using entry = std::pair<T, nodeBase*>;
+        std::vector<entry> buffer;
+        buffer.reserve(size_);
+        for (nodeBase* p = head.p; p != &sentinel_; p = p->next)
+            buffer.emplace_back(value(p), p);
+        parallel::stable_sort(
+                buffer.begin(), buffer.end(),
+                [&](const entry& a, const entry& b) {
+                    return comp(a.first, b.first);
+                });
+
+        nodeBase* prev = nullptr;
+        for (auto& e : buffer) {
+            e.second->prev = prev;
+            if (prev != nullptr) prev->next = e.second;
+            prev = e.second;
+        }
+        relink(buffer.front().second, prev);
+    }
+
+    template <class Compare>
+    void parallelSortAux(Compare comp, std::false_type) {
+        // 切成 k 段以 nullptr 结尾的单链，各段的 prev 在排序后统一修复。
+        const unsigned         k = parallel::detail::chunkCount(size_);
+        std::vector<nodeBase*> runs(k);
+        nodeBase*              p = head.p;
+        for (unsigned i = 0; i != k; ++i) {
+            runs[i]               = p;
+            const size_type count = size_ * (i + 1) / k - size_ * i / k;
+            for (size_type j = 1; j != count; ++j) p = p->next;
+            nodeBase* next = p->next;
+            p->next        = nullptr;
+            p              = next;
+        }
+
+        parallel::detail::forEachChunk(
+                size_, k, [&](unsigned i, size_t, size_t) {
+                    runs[i] = sortChain(runs[i], comp);
+                });
+        while (runs.size() > 1) {
+            const auto pairs = static_cast<unsigned>(runs.size() / 2);
+            std::vector<nodeBase*> merged((runs.size() + 1) / 2);
+            if (runs.size() % 2 != 0) merged.back() = runs.back();
+            parallel::detail::forEachChunk(
+                    size_, pairs, [&](unsigned i, size_t, size_t) {
+                        merged[i] = mergeChains(runs[2 * i], runs[2 * i + 1],
+                                                comp);
+                    });
+            runs.swap(merged);
+        }
+
+        nodeBase* prev = nullptr;
+        for (nodeBase* q = runs[0]; q != nullptr; q = q->next) {
+            q->prev = prev;
+            prev    = q;
+        }
+        relink(runs[0], prev);
+    }
+
+    // 排序后重新设置首尾：first 为第一个节点，last 为最后一个节点，
+    // 两者之间的 next、prev 已经链接好。
+    void relink(nodeBase* first, nodeBase* last) {
+        first->prev  = nullptr;
+        last->next     = &sentinel_;
+        sentinel_.prev = last;
+        head.p       = first;
+    }
+
+    // 稳定地归并两条以 nullptr 结尾的有序单链，a 中的元素排在相等元素之前。
+    template <class Compare>
+    static nodeBase* mergeChains(nodeBase* a, nodeBase* b, Compare& comp) {
+        nodeBase  dummy;
+        nodeBase* t = &dummy;
+        while (a != nullptr && b != nullptr) {
+            if (comp(value(b), value(a))) {
+                t->next = b;
+                b       = b->next;
+            } else {
+                t->next = a;
+                a       = a->next;
+            }
+            t = t->next;
+        }
+        t->next = a != nullptr ? a : b;
+        return dummy.next;
+    }
+
+    // 对以 nullptr 结尾的单链做自底向上的归并排序，不分配内存。
+    // 与 sort 的 counter 数组相同，bins[i] 是 2^i 个节点归并成的有序链。
+    template <class Compare>
+    static nodeBase* sortChain(nodeBase* chain, Compare& comp) {
+        nodeBase* bins[64] = {};
+        int       fill     = 0;
+        while (chain != nullptr) {
+            nodeBase* carry = chain;
+            chain           = chain->next;
+            carry->next     = nullptr;
+            int i           = 0;
+            for (; i < fill && bins[i] != nullptr; ++i) {
+                carry   = mergeChains(bins[i], carry, comp);
+                bins[i] = nullptr;
+            }
+            bins[i] = carry;
+            if (i == fill) ++fill;
+        }
+        nodeBase* result = nullptr;
+        for (int i = 0; i != fill; ++i) {
+            if (bins[i] == nullptr) continue;
+            result = result == nullptr ? bins[i]
+                                       : mergeChains(bins[i], result, comp);
+        }
+        return result;
+    }
+
+    // 将 x 的非空区间 [first, last) 接到 position 之前，不修改 size_。
+    void transfer(iterator position, list& x, iterator first, iterator last) {
+        auto tailNode = last.p->prev;
+        if (x.head.p == first.p) {
+            x.head.p       = last.p;
+            x.head.p->prev = nullptr;
+        } else {
+            first.p->prev->next = last.p;
+            last.p->prev        = first.p->prev;
+        }
+        if (position.p == head.p) {
+            first.p->prev  = nullptr;
+            tailNode->next = head.p;
+            head.p->prev   = tailNode;
+            head.p         = first.p;
+        } else {
+            position.p->prev->next = first.p;
+            first.p->prev          = position.p->prev;
+            tailNode->next         = position.p;
+            position.p->prev       = tailNode;
+        }
+    }
+
+    // 将节点 node 接到 position 之前。
+    void linkBefore(nodeBase* position, nodeBase* node) {
+        node->next = position;
+        node->prev = position->prev;
+        if (position == head.p)
+            head.p = node;
+        else
+            position->prev->next = node;
+        position->prev = node;
+    }
+
+    // 将节点 node 从链表中摘下，node 不能是哨兵。
+    void unlink(nodeBase* node) {
+        node->next->prev = node->prev;
+        if (node == head.p)
+            head.p = node->next;
+        else
+            node->prev->next = node->next;
+    }
+
+    // 改用 pool 分配节点，调用时链表必须为空。
+    void usePool(const std::shared_ptr<pool_type>& pool) {
+        if (pool_ == pool) return;
+        list temp(pool);
+        swap(temp);
+    }
+
+    // 节点池，尚未创建时创建一个本链表独占的节点池。
+    const std::shared_ptr<pool_type>& pool() {
+        if (pool_ == nullptr) pool_ = std::make_shared<pool_type>();
+        return pool_;
+    }
+
+    template <class... Args>
+    nodeBase* newNode(Args&&... args) {
+        nodeType* res = pool()->allocate();
+        try {
+            ::new (static_cast<void*>(res))
+                    nodeType(std::forward<Args>(args)...);
+        } catch (...) {
+            pool_->deallocate(res);
+            throw;
+        }
         return res;
     }
-    void deleteNode(nodePtr p) {
-        p->prev = p->next = nullptr;
-        nodeAllocator::destroy(p);
-        nodeAllocator::deallocate(p);
+    void deleteNode(nodeBase* p) {
+        nodeType* node = static_cast<nodeType*>(p);
+        node->~nodeType();
+        pool()->deallocate(node);
     }
 
-    void insert_aux(iterator position, size_type n, const T& val,
+    template <class Integer>
+    void insert_aux(const_iterator position, Integer n, const T& val,
                     std::true_type) {
-        for (auto i = n; i != 0; --i) { position = insert(position, val); }
+        for (auto i = n; i != 0; --i) emplace(position, val);
     }
     template <class InputIterator>
-    void insert_aux(iterator position, InputIterator first, InputIterator last,
-                    std::false_type) {
-        for (--last; first != last; --last) {
-            position = insert(position, *last);
-        }
-        insert(position, *last);
+    void insert_aux(const_iterator position, InputIterator first,
+                    InputIterator last, std::false_type) {
+        for (; first != last; ++first) emplace(position, *first);
     }
+};
 
-    const_iterator changeIteratorToConstIterator(iterator& it) const;
+template <class T>
+typename list<T>::iterator list<T>::begin() {
+    return head;
+}
 
-  public:
-    friend void swap(list<T>& x, list<T>& y);
-    friend bool operator==(const list<T>& lhs, const list<T>& rhs);
-    friend bool operator!=(const list<T>& lhs, const list<T>& rhs);
-};
+template <class T>
+typename list<T>::iterator list<T>::end() {
+    return iterator(&sentinel_);
+}
+
+template <class T>
+typename list<T>::const_iterator list<T>::begin() const {
+    return const_iterator(head.p);
+}
+
+template <class T>
+typename list<T>::const_iterator list<T>::end() const {
+    return const_iterator(const_cast<detail::listNodeBase*>(&sentinel_));
+}
+
+template <class T>
+void swap(list<T>& x, list<T>& y) {
+    x.swap(y);
+}
 
 template <class T>
 bool operator==(const list<T>& lhs, const list<T>& rhs) {
-    auto node1 = lhs.head.p, node2 = rhs.head.p;
-    for (; node1 != lhs.tail.p && node2 != rhs.tail.p;
-         node1 = node1->next, node2 = node2->next) {
-        if (node1->data != node2->data) break;
-    }
-    if (node1 == lhs.tail.p && node2 == rhs.tail.p) return true;
-    return false;
+    return lhs.size() == rhs.size()
+           && std::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 template <class T>
 bool operator!=(const list<T>& lhs, const list<T>& rhs) {
@@ -329,29 +636,20 @@ bool operator!=(const list<T>& lhs, const list<T>& rhs) {
 
 namespace detail {
 
-// 链表节点结构
-template <class T>
-struct node {
-    T        data;
-    node*    prev;
-    node*    next;
-    list<T>* container;
-    node(const T& d, node* p, node* n, list<T>* c)
-            : data(d), prev(p), next(n), container(c) {}
-    bool operator==(const node& n) {
-        return data == n.data && prev == n.prev && next == n.next
-               && container == n.container;
-    }
-};
-
-// list迭代器
+// list迭代器，T 为 const 类型时是 const_iterator。
 template <class T>
 struct listIterator : public std::iterator<std::bidirectional_iterator_tag, T> {
-    using nodePtr = node<T>*;
+    using nodePtr  = listNodeBase*;
+    using nodeType = node<typename std::remove_const<T>::type>;
 
     nodePtr p;
 
     explicit listIterator(nodePtr ptr = nullptr) : p(ptr) {}
+    // iterator 可以隐式转换为 const_iterator。
+    template <class U, class = typename std::enable_if<
+                               std::is_same<const U, T>::value
+                               && !std::is_same<U, T>::value>::type>
+    listIterator(const listIterator<U>& other) : p(other.p) {}
 
     listIterator& operator++() {
         p = p->next;
@@ -371,11 +669,13 @@ struct listIterator : public std::iterator<std::bidirectional_iterator_tag, T> {
         --*this;
         return res;
     }
-    bool operator==(const listIterator<T>& other) { return p == other.p; }
-    bool operator!=(const listIterator<T>& other) { return !(*this == other); }
+    bool operator==(const listIterator<T>& other) const { return p == other.p; }
+    bool operator!=(const listIterator<T>& other) const {
+        return !(*this == other);
+    }
 
-    T& operator*() { return p->data; }
-    T* operator->() { return &(operator*()); }
+    T& operator*() const { return static_cast<nodeType*>(p)->data; }
+    T* operator->() const { return &(operator*()); }
 };
 }    // namespace detail
 }    // namespace extrastl
@@ -392,4 +692,4 @@ bool operator!=(const extrastl::detail::listIterator<T>& lhs,
     return !(lhs == rhs);
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,622 @@
+#ifndef EXTRASTL_MAP_H
+#define EXTRASTL_MAP_H
+
+#include "rbTree.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace extrastl {
+
+// 表示输入区间已按键升序排列，用于 map、set 的线性时间构造：
+//
+//     extrastl::map<int, int> m(extrastl::sorted_unique, v.begin(), v.end());
+struct sorted_unique_t {
+    explicit sorted_unique_t() = default;
+};
+constexpr sorted_unique_t sorted_unique{};
+
+namespace detail {
+
+// 红黑树的双向迭代器，node 为 NULL 表示尾后位置。
+// 尾后迭代器自减时要取树的最大结点，因此同时保存所属的树。
+template <class Tree, class Value>
+struct rbTreeIterator {
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type        = typename std::remove_const<Value>::type;
+    using difference_type   = ptrdiff_t;
+    using pointer           = Value*;
+    using reference         = Value&;
+
+    using tree_type = Tree;
+    using node_type = typename Tree::node_type;
+
+    node_type*       node;
+    const tree_type* tree;
+
+    explicit rbTreeIterator(node_type*       n = nullptr,
+                            const tree_type* t = nullptr)
+            : node(n), tree(t) {}
+    // iterator 可以隐式转换为 const_iterator。
+    template <class U, class = typename std::enable_if<
+                               std::is_same<const U, Value>::value
+                               && !std::is_same<U, Value>::value>::type>
+    rbTreeIterator(const rbTreeIterator<Tree, U>& other)
+            : node(other.node), tree(other.tree) {}
+
+    rbTreeIterator& operator++() {
+        node = tree->successor(node);
+        return *this;
+    }
+    rbTreeIterator operator++(int) {
+        auto res = *this;
+        ++*this;
+        return res;
+    }
+    rbTreeIterator& operator--() {
+        node = node != nullptr ? tree->predecessor(node) : tree->last();
+        return *this;
+    }
+    rbTreeIterator operator--(int) {
+        auto res = *this;
+        --*this;
+        return res;
+    }
+    bool operator==(const rbTreeIterator& other) const {
+        return node == other.node;
+    }
+    bool operator!=(const rbTreeIterator& other) const {
+        return !(*this == other);
+    }
+
+    Value& operator*() const { return node->key; }
+    Value* operator->() const { return &(operator*()); }
+};
+
+// map 的树中结点比较函数：只比较 pair 的 first。
+// 同时接受键与 pair 的混合比较，供按键查找和异构查找使用。
+template <class Value, class KeyCompare>
+struct mapValueCompare {
+    KeyCompare comp;
+
+    explicit mapValueCompare(const KeyCompare& c) : comp(c) {}
+
+    bool operator()(const Value& a, const Value& b) const {
+        return comp(a.first, b.first);
+    }
+    template <class K>
+    bool operator()(const K& k, const Value& b) const {
+        return comp(k, b.first);
+    }
+    template <class K>
+    bool operator()(const Value& a, const K& k) const {
+        return comp(a.first, k);
+    }
+};
+
+// map 与 set 的公共部分：键唯一的红黑树。
+//
+// TreeCompare 既能比较两个 Value，也能比较键与 Value，
+// 因此插入时可以只用键（或待插入的值本身）查找位置，确认键不存在后才构造结点。
+// KeyCompare 定义了 is_transparent 时，查找类函数接受任意能与键比较的类型。
+template <class Key, class Value, class KeyCompare, class TreeCompare,
+          class IterValue>
+class rbTreeUnique {
+  protected:
+    // 结点维护子树大小，供 select、rank 使用
+    using nodeType  = RBTNode<Value, false, true>;
+    using tree_type = RBTree<Value, TreeCompare, nodeType>;
+
+  public:
+    using key_type        = Key;
+    using value_type      = Value;
+    using key_compare     = KeyCompare;
+    using reference       = Value&;
+    using const_reference = const Value&;
+    using size_type       = size_t;
+    using iterator        = rbTreeIterator<tree_type, IterValue>;
+    using const_iterator  = rbTreeIterator<tree_type, const Value>;
+
+  protected:
+    tree_type tree_;
+
+    // **************************************************************
+    // ************************构造函数*******************************
+    // **************************************************************
+    explicit rbTreeUnique(const TreeCompare& comp) : tree_(comp) {}
+    rbTreeUnique(const rbTreeUnique& x) : tree_(x.tree_.comp()) {
+        tree_.assign_sorted(x.begin(), x.end());
+    }
+    // 树在第一次插入时才创建结点池，移动构造不分配内存
+    rbTreeUnique(rbTreeUnique&& x) noexcept(
+            std::is_nothrow_copy_constructible<TreeCompare>::value)
+            : tree_(x.tree_.comp()) {
+        swap(x);
+    }
+    rbTreeUnique& operator=(const rbTreeUnique& x) {
+        if (this != &x) {
+            rbTreeUnique temp(x);
+            swap(temp);
+        }
+        return *this;
+    }
+    rbTreeUnique& operator=(rbTreeUnique&& x) {
+        if (this != &x) {
+            rbTreeUnique temp(std::move(x));
+            swap(temp);
+        }
+        return *this;
+    }
+
+  public:
+    // **************************************************************
+    // ***************************迭代器********************************
+    // **************************************************************
+    iterator       begin() { return iterator(tree_.first(), &tree_); }
+    iterator       end() { return iterator(nullptr, &tree_); }
+    const_iterator begin() const {
+        return const_iterator(tree_.first(), &tree_);
+    }
+    const_iterator end() const { return const_iterator(nullptr, &tree_); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    // **************************************************************
+    // ***************************容量********************************
+    // **************************************************************
+    bool      empty() const { return tree_.size() == 0; }
+    size_type size() const { return tree_.size(); }
+
+    // **************************************************************
+    // ***************************修改********************************
+    // **************************************************************
+
+    // 键已存在时不构造结点，返回已有元素与 false。
+    std::pair<iterator, bool> insert(const value_type& val) {
+        return emplaceWithKey(val, val);
+    }
+    std::pair<iterator, bool> insert(value_type&& val) {
+        return emplaceWithKey(val, std::move(val));
+    }
+    // hint 只用于兼容 std::inserter，不影响查找。
+    iterator insert(const_iterator, const value_type& val) {
+        return insert(val).first;
+    }
+    // 有序输入时每个元素直接挂到最大结点之后，不必从根查找。
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last) {
+        for (; first != last; ++first) {
+            const value_type& val = *first;
+            nodeType*         parent;
+            bool              isLeft;
+            if (findSlotFromEnd(val, parent, isLeft) == nullptr) {
+                tree_.link(tree_.newNode(val), parent, isLeft);
+            }
+        }
+    }
+
+    // 用按键升序排列的区间替换全部元素，O(n)。等价的键只保留第一个。
+    template <class InputIterator>
+    void assign_sorted(InputIterator first, InputIterator last) {
+        tree_.assign_sorted(first, last, true);
+    }
+    // 批量插入任意顺序的区间：先排序，再与已有元素归并后整体重建。
+    // 适合一次插入大量元素，少量插入仍应使用 insert。
+    template <class InputIterator>
+    void insert_range(InputIterator first, InputIterator last) {
+        tree_.insert_range(first, last, true);
+    }
+
+    iterator erase(const_iterator position) {
+        return makeIterator(tree_.erase(position.node));
+    }
+    iterator erase(const_iterator first, const_iterator last) {
+        while (first != last) first = erase(first);
+        return makeIterator(last.node);
+    }
+    size_type erase(const key_type& k) {
+        nodeType* x = tree_.find(k);
+        if (x == nullptr) return 0;
+        tree_.erase(x);
+        return 1;
+    }
+
+    void clear() { tree_.destroy(); }
+
+    void swap(rbTreeUnique& x) noexcept { tree_.swap(x.tree_); }
+
+    // 集合运算，结果留在本容器中，x 变为空。两者都有的键保留本容器的元素。
+    // 结点直接在两棵树之间移动，较大时左右两半并行计算，见 RBTree::union_with。
+    void union_with(rbTreeUnique& x) { tree_.union_with(x.tree_); }
+    void intersect_with(rbTreeUnique& x) { tree_.intersect_with(x.tree_); }
+    void difference_with(rbTreeUnique& x) { tree_.difference_with(x.tree_); }
+
+    // **************************************************************
+    // ***************************查找********************************
+    // **************************************************************
+    iterator find(const key_type& k) { return makeIterator(tree_.find(k)); }
+    const_iterator find(const key_type& k) const {
+        return makeIterator(tree_.find(k));
+    }
+    size_type count(const key_type& k) const {
+        return tree_.find(k) != nullptr ? 1 : 0;
+    }
+    iterator lower_bound(const key_type& k) {
+        return makeIterator(tree_.lowerBound(k));
+    }
+    const_iterator lower_bound(const key_type& k) const {
+        return makeIterator(tree_.lowerBound(k));
+    }
+    iterator upper_bound(const key_type& k) {
+        return makeIterator(tree_.upperBound(k));
+    }
+    const_iterator upper_bound(const key_type& k) const {
+        return makeIterator(tree_.upperBound(k));
+    }
+    std::pair<iterator, iterator> equal_range(const key_type& k) {
+        return equalRange<iterator>(k);
+    }
+    std::pair<const_iterator, const_iterator> equal_range(
+            const key_type& k) const {
+        return equalRange<const_iterator>(k);
+    }
+
+    // 第 k 小（从 0 开始计）的元素，k >= size() 时返回 end()。O(log n)
+    iterator select(size_type k) { return makeIterator(tree_.select(k)); }
+    const_iterator select(size_type k) const {
+        return makeIterator(tree_.select(k));
+    }
+    // 小于 k 的元素个数，即 lower_bound(k) 的下标。O(log n)
+    size_type rank(const key_type& k) const { return tree_.rank(k); }
+    // 迭代器所指元素的下标，end() 的下标为 size()。O(log n)
+    size_type index_of(const_iterator position) const {
+        return position.node != nullptr ? tree_.indexOf(position.node)
+                                        : size();
+    }
+
+    // 异构查找，仅在 KeyCompare::is_transparent 存在时可用：
+    //
+    //     extrastl::map<std::string, int, std::less<>> m;
+    //     m.find("key");    // 不构造临时 std::string
+    template <class K, class C = KeyCompare, class = typename C::is_transparent>
+    iterator find(const K& k) {
+        return makeIterator(tree_.find(k));
+    }
+    template <class K, class C = KeyCompare, class = typename C::is_transparent>
+    const_iterator find(const K& k) const {
+        return makeIterator(tree_.find(k));
+    }
+    template <class K, class C = KeyCompare, class = typename C::is_transparent>
+    size_type count(const K& k) const {
+        return tree_.find(k) != nullptr ? 1 : 0;
+    }
+    template <class K, class C = KeyCompare, class = typename C::is_transparent>
+    iterator lower_bound(const K& k) {
+        return makeIterator(tree_.lowerBound(k));
+    }
+    template <class K, class C = KeyCompare, class = typename C::is_transparent>
+    const_iterator lower_bound(const K& k) const {
+        return makeIterator(tree_.lowerBound(k));
+    }
+    template <class K, class C = KeyCompare, class = typename C::is_transparent>
+    iterator upper_bound(const K& k) {
+        return makeIterator(tree_.upperBound(k));
+    }
+    template <class K, class C = KeyCompare, class = typename C::is_transparent>
+    const_iterator upper_bound(const K& k) const {
+        return makeIterator(tree_.upperBound(k));
+    }
+    template <class K, class C = KeyCompare, class = typename C::is_transparent>
+    size_type rank(const K& k) const {
+        return tree_.rank(k);
+    }
+    template <class K, class C = KeyCompare, class = typename C::is_transparent>
+    std::pair<iterator, iterator> equal_range(const K& k) {
+        return equalRange<iterator>(k);
+    }
+    template <class K, class C = KeyCompare, class = typename C::is_transparent>
+    std::pair<const_iterator, const_iterator> equal_range(const K& k) const {
+        return equalRange<const_iterator>(k);
+    }
+
+  protected:
+    iterator makeIterator(nodeType* x) { return iterator(x, &tree_); }
+    const_iterator makeIterator(nodeType* x) const {
+        return const_iterator(x, &tree_);
+    }
+
+    // 键唯一，等价区间至多一个元素，一次 lowerBound 即可确定。
+    template <class It, class K>
+    std::pair<It, It> equalRange(const K& k) const {
+        nodeType* x = tree_.lowerBound(k);
+        if (x == nullptr || tree_.comp()(k, x->key)) {
+            return std::pair<It, It>(It(x, &tree_), It(x, &tree_));
+        }
+        return std::pair<It, It>(It(x, &tree_),
+                                 It(tree_.successor(x), &tree_));
+    }
+
+    // 先用 k 查找插入位置，键不存在时才用 args 构造结点。
+    template <class K, class... Args>
+    std::pair<iterator, bool> emplaceWithKey(const K& k, Args&&... args) {
+        nodeType* parent;
+        bool      isLeft;
+        nodeType* x = tree_.findSlot(k, parent, isLeft);
+        if (x != nullptr) {
+            return std::pair<iterator, bool>(makeIterator(x), false);
+        }
+        x = tree_.newNode(std::forward<Args>(args)...);
+        tree_.link(x, parent, isLeft);
+        return std::pair<iterator, bool>(makeIterator(x), true);
+    }
+
+    // 无法从参数中直接取得键时，只能先构造结点再查找，键已存在时销毁该结点。
+    template <class... Args>
+    std::pair<iterator, bool> emplaceNode(Args&&... args) {
+        nodeType* node = tree_.newNode(std::forward<Args>(args)...);
+        nodeType* parent;
+        bool      isLeft;
+        nodeType* x = tree_.findSlot(node->key, parent, isLeft);
+        if (x != nullptr) {
+            tree_.deleteNode(node);
+            return std::pair<iterator, bool>(makeIterator(x), false);
+        }
+        tree_.link(node, parent, isLeft);
+        return std::pair<iterator, bool>(makeIterator(node), true);
+    }
+
+    // 与 findSlot 相同，但先检查 v 是否大于当前最大元素。
+    template <class V>
+    nodeType* findSlotFromEnd(const V& v, nodeType*& parent, bool& isLeft) {
+        nodeType* last = tree_.last();
+        if (last != nullptr && tree_.comp()(last->key, v)) {
+            parent = last;
+            isLeft = false;
+            return nullptr;
+        }
+        return tree_.findSlot(v, parent, isLeft);
+    }
+};
+
+// map::emplace 的参数是否直接给出了键：(key, mapped) 或者一个 pair。
+// Args 已经过 decay。
+template <class Key, class... Args>
+struct mapEmplaceHasKey : std::false_type {};
+template <class Key, class A, class B>
+struct mapEmplaceHasKey<Key, A, B> : std::is_same<Key, A> {};
+template <class Key, class A, class B>
+struct mapEmplaceHasKey<Key, std::pair<A, B>>
+        : std::is_same<Key, typename std::remove_const<A>::type> {};
+
+// set::emplace 的参数是否恰为一个键
+template <class Key, class... Args>
+struct setEmplaceHasKey : std::false_type {};
+template <class Key>
+struct setEmplaceHasKey<Key, Key> : std::true_type {};
+}    // namespace detail
+
+// 基于 RBTree 的有序关联容器，键唯一。
+//
+// 迭代器为双向迭代器，按键的升序遍历，插入和删除其他元素不会使其失效。
+// emplace(key, mapped...)、try_emplace、operator[] 与 insert 都先按键查找，
+// 键已存在时不会构造结点：
+//
+//     extrastl::map<int, std::string> m;
+//     m.try_emplace(1, 3, 'a');    // 插入 {1, "aaa"}
+//     m.try_emplace(1, 3, 'b');    // 键已存在，不构造 std::string
+//     for (auto it = m.lower_bound(lo); it != m.end() && it->first < hi; ++it)
+//         ...
+template <class Key, class T, class Compare = std::less<Key>>
+class map : public detail::rbTreeUnique<
+                    Key, std::pair<const Key, T>, Compare,
+                    detail::mapValueCompare<std::pair<const Key, T>, Compare>,
+                    std::pair<const Key, T>> {
+  private:
+    using valueCompare =
+            detail::mapValueCompare<std::pair<const Key, T>, Compare>;
+    using base = detail::rbTreeUnique<Key, std::pair<const Key, T>, Compare,
+                                      valueCompare, std::pair<const Key, T>>;
+
+  public:
+    using mapped_type = T;
+    using typename base::key_type;
+    using typename base::value_type;
+    using typename base::iterator;
+    using typename base::const_iterator;
+    using typename base::size_type;
+
+    // **************************************************************
+    // ************************构造函数*******************************
+    // **************************************************************
+    map() : base(valueCompare(Compare())) {}
+    explicit map(const Compare& comp) : base(valueCompare(comp)) {}
+    template <class InputIterator>
+    map(InputIterator first, InputIterator last,
+        const Compare& comp = Compare())
+            : base(valueCompare(comp)) {
+        this->insert(first, last);
+    }
+    // [first, last) 须按键升序排列，O(n)。
+    template <class InputIterator>
+    map(sorted_unique_t, InputIterator first, InputIterator last,
+        const Compare& comp = Compare())
+            : base(valueCompare(comp)) {
+        this->assign_sorted(first, last);
+    }
+
+    // **************************************************************
+    // ************************元素访问*******************************
+    // **************************************************************
+    // 键不存在时插入值初始化的 mapped_type。
+    T& operator[](const key_type& k) { return try_emplace(k).first->second; }
+    T& operator[](key_type&& k) {
+        return try_emplace(std::move(k)).first->second;
+    }
+    T& at(const key_type& k) {
+        auto* x = this->tree_.find(k);
+        if (x == nullptr) throw std::out_of_range("Out Of Range");
+        return x->key.second;
+    }
+    const T& at(const key_type& k) const {
+        auto* x = this->tree_.find(k);
+        if (x == nullptr) throw std::out_of_range("Out Of Range");
+        return x->key.second;
+    }
+
+    // **************************************************************
+    // ***************************修改********************************
+    // **************************************************************
+    using base::insert;
+
+    template <class... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        return emplaceDispatch(
+                detail::mapEmplaceHasKey<Key,
+                                         typename std::decay<Args>::type...>(),
+                std::forward<Args>(args)...);
+    }
+
+    // 键不存在时才以 args 构造 mapped_type，k 不会被移走。
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(const key_type& k, Args&&... args) {
+        return this->emplaceWithKey(
+                k, std::piecewise_construct, std::forward_as_tuple(k),
+                std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(key_type&& k, Args&&... args) {
+        return this->emplaceWithKey(
+                k, std::piecewise_construct,
+                std::forward_as_tuple(std::move(k)),
+                std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    // **************************************************************
+    // ***************************观察器********************************
+    // **************************************************************
+    Compare      key_comp() const { return this->tree_.comp().comp; }
+    valueCompare value_comp() const { return this->tree_.comp(); }
+
+  private:
+    // (key, mapped) 形式：用第一个参数查找
+    template <class A, class B>
+    std::pair<iterator, bool> emplaceDispatch(std::true_type, A&& a, B&& b) {
+        return this->emplaceWithKey(a, std::forward<A>(a), std::forward<B>(b));
+    }
+    // pair 形式：用 pair 的 first 查找
+    template <class P>
+    std::pair<iterator, bool> emplaceDispatch(std::true_type, P&& p) {
+        return this->emplaceWithKey(p.first, std::forward<P>(p));
+    }
+    template <class... Args>
+    std::pair<iterator, bool> emplaceDispatch(std::false_type,
+                                              Args&&... args) {
+        return this->emplaceNode(std::forward<Args>(args)...);
+    }
+};
+
+// 基于 RBTree 的有序集合，键唯一，元素不可通过迭代器修改。
+// 接口与 map 相同，emplace 的参数恰为一个 Key 时先查找再构造。
+template <class Key, class Compare = std::less<Key>>
+class set : public detail::rbTreeUnique<Key, Key, Compare, Compare,
+                                        const Key> {
+  private:
+    using base = detail::rbTreeUnique<Key, Key, Compare, Compare, const Key>;
+
+  public:
+    using typename base::key_type;
+    using typename base::value_type;
+    using typename base::iterator;
+    using typename base::const_iterator;
+    using typename base::size_type;
+
+    // **************************************************************
+    // ************************构造函数*******************************
+    // **************************************************************
+    set() : base(Compare()) {}
+    explicit set(const Compare& comp) : base(comp) {}
+    template <class InputIterator>
+    set(InputIterator first, InputIterator last,
+        const Compare& comp = Compare())
+            : base(comp) {
+        this->insert(first, last);
+    }
+    // [first, last) 须升序排列，O(n)。
+    template <class InputIterator>
+    set(sorted_unique_t, InputIterator first, InputIterator last,
+        const Compare& comp = Compare())
+            : base(comp) {
+        this->assign_sorted(first, last);
+    }
+
+    // **************************************************************
+    // ***************************修改********************************
+    // **************************************************************
+    template <class... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        return emplaceDispatch(
+                detail::setEmplaceHasKey<Key,
+                                         typename std::decay<Args>::type...>(),
+                std::forward<Args>(args)...);
+    }
+
+    // **************************************************************
+    // ***************************观察器********************************
+    // **************************************************************
+    Compare key_comp() const { return this->tree_.comp(); }
+    Compare value_comp() const { return this->tree_.comp(); }
+
+  private:
+    template <class K>
+    std::pair<iterator, bool> emplaceDispatch(std::true_type, K&& k) {
+        return this->emplaceWithKey(k, std::forward<K>(k));
+    }
+    template <class... Args>
+    std::pair<iterator, bool> emplaceDispatch(std::false_type,
+                                              Args&&... args) {
+        return this->emplaceNode(std::forward<Args>(args)...);
+    }
+};
+
+template <class Key, class T, class Compare>
+void swap(map<Key, T, Compare>& x, map<Key, T, Compare>& y) {
+    x.swap(y);
+}
+
+template <class Key, class Compare>
+void swap(set<Key, Compare>& x, set<Key, Compare>& y) {
+    x.swap(y);
+}
+
+template <class Key, class T, class Compare>
+bool operator==(const map<Key, T, Compare>& lhs,
+                const map<Key, T, Compare>& rhs) {
+    return lhs.size() == rhs.size()
+           && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class Key, class T, class Compare>
+bool operator!=(const map<Key, T, Compare>& lhs,
+                const map<Key, T, Compare>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <class Key, class Compare>
+bool operator==(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs) {
+    return lhs.size() == rhs.size()
+           && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class Key, class Compare>
+bool operator!=(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs) {
+    return !(lhs == rhs);
+}
+}    // namespace extrastl
+
+#endif
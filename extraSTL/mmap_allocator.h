@@ -0,0 +1,108 @@
+#ifndef EXTRASTL_MMAP_ALLOCATOR_H
+#define EXTRASTL_MMAP_ALLOCATOR_H
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+namespace extrastl {
+
+// 直接使用匿名 mmap 分配内存的分配器，适合数百 MB 级别的大 vector：
+//
+//     extrastl::vector<int, extrastl::mmapAllocator<int>> column;
+//
+// 提供 reallocate，元素可平凡复制时 vector 扩容会交给它完成。
+// Linux 上通过 mremap 重新映射页表，不复制数据，也不会出现新旧两块内存同时存在的峰值；
+// 其他平台退化为 mmap + memcpy。
+//
+// HugePages 为 true 时按 2MB 取整并用 madvise 申请透明大页，减少 TLB 缺失。
+// 每次分配至少占用一页，不适合小对象。
+template <class T, bool HugePages = false>
+class mmapAllocator {
+  public:
+    using value_type = T;
+
+    template <class U>
+    struct rebind {
+        using other = mmapAllocator<U, HugePages>;
+    };
+
+    mmapAllocator() noexcept = default;
+    template <class U>
+    mmapAllocator(const mmapAllocator<U, HugePages>&) noexcept {}
+
+    T* allocate(size_t n) {
+        if (n == 0) return nullptr;
+        void* p = ::mmap(nullptr, bytes(n), PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) throw std::bad_alloc();
+        adviseHugePages(p, bytes(n));
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (p != nullptr) ::munmap(p, bytes(n));
+    }
+
+    // 将 p 处容量为 oldN 的空间调整为 newN，保留前 min(oldN, newN) 个元素的字节内容，
+    // 返回新的地址（可能与 p 不同）。
+    T* reallocate(T* p, size_t oldN, size_t newN) {
+        if (p == nullptr) return allocate(newN);
+        if (newN == 0) {
+            deallocate(p, oldN);
+            return nullptr;
+        }
+        if (bytes(oldN) == bytes(newN)) return p;
+#if defined(__linux__)
+        void* q = ::mremap(p, bytes(oldN), bytes(newN), MREMAP_MAYMOVE);
+        if (q == MAP_FAILED) throw std::bad_alloc();
+        adviseHugePages(q, bytes(newN));
+        return static_cast<T*>(q);
+#else
+        T* q = allocate(newN);
+        std::memcpy(q, p, (oldN < newN ? oldN : newN) * sizeof(T));
+        deallocate(p, oldN);
+        return q;
+#endif
+    }
+
+    template <class U>
+    bool operator==(const mmapAllocator<U, HugePages>&) const noexcept {
+        return true;
+    }
+    template <class U>
+    bool operator!=(const mmapAllocator<U, HugePages>&) const noexcept {
+        return false;
+    }
+
+  private:
+    static const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    // 映射的粒度：普通页或 2MB 大页。
+    static size_t granularity() {
+        static const size_t pageSize = ::sysconf(_SC_PAGESIZE);
+        if (HugePages) return HUGE_PAGE_SIZE;
+        return pageSize;
+    }
+
+    // 将 n 个元素占用的字节数上调至映射粒度的整数倍。
+    static size_t bytes(size_t n) {
+        const size_t g = granularity();
+        return (n * sizeof(T) + g - 1) / g * g;
+    }
+
+    static void adviseHugePages(void* p, size_t len) {
+#if defined(MADV_HUGEPAGE)
+        if (HugePages) ::madvise(p, len, MADV_HUGEPAGE);
+#else
+        (void)p;
+        (void)len;
+#endif
+    }
+};
+}    // namespace extrastl
+
+#endif
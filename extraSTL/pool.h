@@ -0,0 +1,127 @@
+#ifndef EXTRASTL_POOL_H
+#define EXTRASTL_POOL_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+namespace extrastl {
+
+// 固定大小对象的节点池，供 list、rbTree 等基于节点的容器使用。
+//
+// 内存按块（chunk）向系统申请，每块容纳多个节点，块的大小从 32 个节点开始
+// 倍增到 maxChunkNodes 为止。归还的节点挂在空闲链表上，下次分配时优先复用，
+// 只有池本身析构或调用 release() 时才把整块内存还给系统。
+//
+// allocate 返回的是未初始化的空间，构造与析构由调用者负责。非线程安全。
+template <class T>
+class nodePool {
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+                  "nodePool 不支持超过 max_align_t 的对齐要求");
+
+  public:
+    // maxChunkNodes 为单个内存块最多容纳的节点数。
+    explicit nodePool(size_t maxChunkNodes = 4096)
+            : chunks_(nullptr), free_(nullptr), cur_(nullptr), end_(nullptr),
+              nextChunkNodes_(32),
+              maxChunkNodes_(maxChunkNodes != 0 ? maxChunkNodes : 1) {
+        if (nextChunkNodes_ > maxChunkNodes_) nextChunkNodes_ = maxChunkNodes_;
+    }
+    nodePool(const nodePool&) = delete;
+    nodePool& operator=(const nodePool&) = delete;
+    ~nodePool() { release(); }
+
+    // 取出一个未初始化的节点空间。
+    T* allocate() {
+        slot* s;
+        if (free_ != nullptr) {
+            s     = free_;
+            free_ = s->next;
+        } else {
+            if (cur_ == end_) newChunk();
+            s = cur_++;
+        }
+        return reinterpret_cast<T*>(s);
+    }
+
+    // 归还 allocate 取得的节点空间，节点必须已经析构。
+    void deallocate(T* p) noexcept {
+        slot* s = reinterpret_cast<slot*>(p);
+        s->next = free_;
+        free_   = s;
+    }
+
+    // 释放所有内存块，之前分配的节点全部失效。
+    void release() noexcept {
+        while (chunks_ != nullptr) {
+            chunk* next = chunks_->next;
+            ::operator delete(chunks_);
+            chunks_ = next;
+        }
+        free_ = cur_ = end_ = nullptr;
+    }
+
+    // 接管 other 的全部内存块，other 分配出的节点此后可以归还给本池，
+    // other 变为空池。需要遍历 other 的空闲链表与块链表。
+    void merge(nodePool& other) noexcept {
+        if (&other == this) return;
+        // other 最新块中尚未使用的部分直接挂到空闲链表上
+        for (slot* s = other.cur_; s != other.end_; ++s) {
+            s->next = free_;
+            free_   = s;
+        }
+        if (other.free_ != nullptr) {
+            slot* last = other.free_;
+            while (last->next != nullptr) last = last->next;
+            last->next = free_;
+            free_      = other.free_;
+        }
+        if (other.chunks_ != nullptr) {
+            chunk* last = other.chunks_;
+            while (last->next != nullptr) last = last->next;
+            last->next = chunks_;
+            chunks_    = other.chunks_;
+        }
+        other.chunks_ = nullptr;
+        other.free_ = other.cur_ = other.end_ = nullptr;
+    }
+
+  private:
+    union slot {
+        slot* next;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    // 块头之后紧跟 n 个 slot。
+    struct chunk {
+        chunk* next;
+    };
+    static const size_t HEADER_SIZE =
+            (sizeof(chunk) + alignof(slot) - 1) / alignof(slot) * alignof(slot);
+
+    void newChunk() {
+        const size_t n     = nextChunkNodes_;
+        const size_t bytes = HEADER_SIZE + n * sizeof(slot);
+        auto*        c     = static_cast<chunk*>(::operator new(bytes));
+        c->next            = chunks_;
+        chunks_            = c;
+        cur_ = reinterpret_cast<slot*>(reinterpret_cast<char*>(c)
+                                       + HEADER_SIZE);
+        end_ = cur_ + n;
+        if (nextChunkNodes_ < maxChunkNodes_) {
+            nextChunkNodes_ = nextChunkNodes_ * 2 < maxChunkNodes_
+                                      ? nextChunkNodes_ * 2
+                                      : maxChunkNodes_;
+        }
+    }
+
+    chunk* chunks_;            // 所有内存块组成的链表
+    slot*  free_;              // 已归还节点组成的空闲链表
+    slot*  cur_;               // 最新内存块中尚未使用过的部分 [cur_, end_)
+    slot*  end_;
+    size_t nextChunkNodes_;    // 下一个内存块容纳的节点数
+    size_t maxChunkNodes_;
+};
+}    // namespace extrastl
+
+#endif
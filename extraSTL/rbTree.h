@@ -1,34 +1,172 @@
 #ifndef EXTRASTL_RBTREE_H
 #define EXTRASTL_RBTREE_H
 
+#include "algorithm.h"
+#include "pool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <functional>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
 using namespace std;
 
 namespace extrastl {
 
 enum RBTColor { RED, BLACK };
 
-template <class T>
-class RBTNode {
+namespace detail {
+// RBTNode 中的键值、父结点与颜色，按颜色的存放方式特化：
+// PackColor 为 false 时颜色单独占一个字段，与键值放在一起以减少填充；
+// 为 true 时颜色存放在父结点指针的最低位（指针按对齐要求最低位恒为 0）。
+template <class Node, class T, bool PackColor>
+class rbNodeLink;
+
+template <class Node, class T>
+class rbNodeLink<Node, T, false> {
   public:
     RBTColor color;     // 颜色
     T        key;       // 关键字(键值)
-    RBTNode* left;      // 左孩子
-    RBTNode* right;     // 右孩子
-    RBTNode* parent;    // 父结点
+    Node*    parent;    // 父结点
+
+    template <class... Args>
+    explicit rbNodeLink(Args&&... args) : key(std::forward<Args>(args)...) {}
+
+    Node*    getParent() const { return parent; }
+    RBTColor getColor() const { return color; }
+    void     setParent(Node* p) { parent = p; }
+    void     setColor(RBTColor c) { color = c; }
+    void     setParentAndColor(Node* p, RBTColor c) {
+        parent = p;
+        color  = c;
+    }
+};
+
+template <class Node, class T>
+class rbNodeLink<Node, T, true> {
+  public:
+    T         key;            // 关键字(键值)
+    uintptr_t parentColor;    // 父结点指针 | 颜色
+
+    template <class... Args>
+    explicit rbNodeLink(Args&&... args) : key(std::forward<Args>(args)...) {}
+
+    Node* getParent() const {
+        return reinterpret_cast<Node*>(parentColor & ~uintptr_t(1));
+    }
+    RBTColor getColor() const { return RBTColor(parentColor & 1); }
+    void     setParent(Node* p) {
+        parentColor = reinterpret_cast<uintptr_t>(p) | (parentColor & 1);
+    }
+    void setColor(RBTColor c) {
+        parentColor = (parentColor & ~uintptr_t(1)) | uintptr_t(c);
+    }
+    void setParentAndColor(Node* p, RBTColor c) {
+        parentColor = reinterpret_cast<uintptr_t>(p) | uintptr_t(c);
+    }
+};
+
+// RBTNode 中的子树大小。RBTree 只通过以下函数维护子树大小，
+// 不维护时它们都是空操作，结点中也没有 size 字段。
+template <class Node, bool CountSize>
+class rbNodeSize;
+
+template <class Node>
+class rbNodeSize<Node, true> {
+  public:
+    size_t size;    // 以该结点为根的子树的结点个数
+
+    rbNodeSize() : size(1) {}
+
+    void setSize(size_t n) { size = n; }
+    void addSize(size_t n) { size += n; }
+    void subSize(size_t n) { size -= n; }
+    // 由左右孩子重新计算子树大小
+    void updateSize() {
+        const Node* x = static_cast<const Node*>(this);
+        size = 1;
+        if (x->left != NULL) size += x->left->size;
+        if (x->right != NULL) size += x->right->size;
+    }
+};
+
+template <class Node>
+class rbNodeSize<Node, false> {
+  public:
+    void setSize(size_t) {}
+    void addSize(size_t) {}
+    void subSize(size_t) {}
+    void updateSize() {}
+};
+}    // namespace detail
+
+// 红黑树结点。
+//
+// PackColor 为 true 时颜色存放在父结点指针的最低位，每个结点省去颜色字段
+// 及其对齐填充：64 位平台上 8 字节的键值每个结点省 8 字节；4 字节及更小的
+// 键值与颜色字段本来就共用 8 字节，打包没有收益。
+// 父结点与颜色只通过 getParent/getColor 等函数（以及 RBTree 中的 rb_* 宏）
+// 访问，与存放方式无关。
+//
+// CountSize 为 true 时每个结点记录子树大小，RBTree 由此支持 O(log n) 的
+// select、rank 与 indexOf。代价是每个结点多 8 字节（RBTNode<long> 从
+// 40 字节变为 48 字节），插入、删除和旋转时还要沿路径更新 size，
+// 因此默认不维护，需要顺序统计时选用 RBTNode<T, false, true>。
+template <class T, bool PackColor = false, bool CountSize = false>
+class RBTNode
+        : public detail::rbNodeLink<RBTNode<T, PackColor, CountSize>, T,
+                                    PackColor>,
+          public detail::rbNodeSize<RBTNode<T, PackColor, CountSize>,
+                                    CountSize> {
+    using link_type = detail::rbNodeLink<RBTNode, T, PackColor>;
+
+  public:
+    static const bool countSize = CountSize;
+
+    RBTNode* left;     // 左孩子
+    RBTNode* right;    // 右孩子
 
     RBTNode(T value, RBTColor c, RBTNode* p, RBTNode* l, RBTNode* r)
-            : key(value), color(c), parent(), left(l), right(r) {}
+            : link_type(std::move(value)), left(l), right(r) {
+        this->setParentAndColor(p, c);
+    }
+    // 以 args 原地构造键值，父结点与孩子均为空。
+    template <class... Args>
+    explicit RBTNode(RBTColor c, Args&&... args)
+            : link_type(std::forward<Args>(args)...), left(NULL),
+              right(NULL) {
+        this->setParentAndColor(NULL, c);
+    }
 };
 
-template <class T>
+// 结点从 nodePool 中分配。默认每棵树有自己的结点池，第一次插入时才创建，
+// destroy() 时整块释放；
+// 也可以在构造时传入与其他树共用的结点池，split 得到的两棵树总是共用结点池。
+// 键值之间用 Compare 比较，相等的键值按插入顺序排在右侧。
+// Node 是结点类型，例如 RBTNode<T, true> 选择把颜色打包进父结点指针，
+// RBTNode<T, false, true> 维护子树大小以支持 select、rank。
+template <class T, class Compare = std::less<T>, class Node = RBTNode<T>>
 class RBTree {
+  public:
+    using node_type = Node;
+    using pool_type = nodePool<Node>;
+
   private:
-    RBTNode<T>* mRoot;    // 根结点
+    Node*                      mRoot;    // 根结点
+    size_t                     mSize;    // 结点个数
+    Compare                    mComp;    // 键值比较函数
+    std::shared_ptr<pool_type> pool_;    // 结点内存池，为空表示尚未创建
 
   public:
-    RBTree();
+    // 不分配内存，结点池在第一次分配结点时创建
+    explicit RBTree(const Compare& comp = Compare());
+    explicit RBTree(std::shared_ptr<pool_type> pool,
+                    const Compare&             comp = Compare());
     ~RBTree();
 
     // 前序遍历"红黑树"
@@ -38,10 +176,29 @@ class RBTree {
     // 后序遍历"红黑树"
     void postOrder();
 
-    // (递归实现)查找"红黑树"中键值为key的节点
-    RBTNode<T>* search(T key);
+    // 按前序、中序、后序对每个键值调用 visit(const T&)。
+    // 借助父指针迭代，不递归也不需要额外的栈。
+    template <class Visitor>
+    void preOrder(Visitor visit) const;
+    template <class Visitor>
+    void inOrder(Visitor visit) const;
+    template <class Visitor>
+    void postOrder(Visitor visit) const;
+    // 按升序对 [lo, hi) 中的每个键值调用 visit
+    template <class K1, class K2, class Visitor>
+    void inOrder(const K1& lo, const K2& hi, Visitor visit) const;
+
+    // 分批导出的游标，遍历期间不能修改树
+    class cursor;
+    // 按升序遍历整棵树、[lo, hi) 的游标
+    cursor scan() const;
+    template <class K1, class K2>
+    cursor scan(const K1& lo, const K2& hi) const;
+
+    // 查找"红黑树"中键值为key的节点，与 iterativeSearch 相同
+    Node* search(T key);
     // (非递归实现)查找"红黑树"中键值为key的节点
-    RBTNode<T>* iterativeSearch(T key);
+    Node* iterativeSearch(T key);
 
     // 查找最小结点：返回最小结点的键值。
     T minimum();
@@ -49,13 +206,24 @@ class RBTree {
     T maximum();
 
     // 找结点(x)的后继结点。即，查找"红黑树中数据值大于该结点"的"最小结点"。
-    RBTNode<T>* successor(RBTNode<T>* x);
+    Node* successor(Node* x) const;
     // 找结点(x)的前驱结点。即，查找"红黑树中数据值小于该结点"的"最大结点"。
-    RBTNode<T>* predecessor(RBTNode<T>* x);
+    Node* predecessor(Node* x) const;
 
     // 将结点(key为节点键值)插入到红黑树中
     void insert(T key);
 
+    // 用有序区间 [first, last) 重建红黑树，O(n)，不做任何旋转。
+    // unique 为 true 时丢弃与前一个元素等价的元素。
+    template <class InputIterator>
+    void assign_sorted(InputIterator first, InputIterator last,
+                       bool unique = false);
+    // 批量插入：新元素排序后与已有结点归并，再整体重建，O(n + m log m)。
+    // unique 为 true 时丢弃已存在的键以及区间中重复的键（保留先出现的）。
+    template <class InputIterator>
+    void insert_range(InputIterator first, InputIterator last,
+                      bool unique = false);
+
     // 删除结点(key为节点键值)
     void remove(T key);
 
@@ -65,176 +233,459 @@ class RBTree {
     // 打印红黑树
     void print();
 
+    // ********************************************************
+    // ****以下结点级接口供 map、set 等基于红黑树的容器使用****
+    // ********************************************************
+
+    size_t         size() const { return mSize; }
+    const Compare& comp() const { return mComp; }
+
+    // 最小、最大结点，空树时返回 NULL
+    Node* first() const { return minimum(mRoot); }
+    Node* last() const { return maximum(mRoot); }
+
+    // 第一个不小于 k 的结点、第一个大于 k 的结点，不存在时返回 NULL。
+    // K 可以与 T 不同，只要 Compare 能比较 K 与 T。
+    template <class K>
+    Node* lowerBound(const K& k) const;
+    template <class K>
+    Node* upperBound(const K& k) const;
+    // 与 k 等价的第一个结点，不存在时返回 NULL
+    template <class K>
+    Node* find(const K& k) const;
+
+    // 以下三个函数要求 Node 维护子树大小（RBTNode 的 CountSize 为 true）。
+    // 第 k 小（从 0 开始计）的结点，k >= size() 时返回 NULL。O(log n)
+    Node* select(size_t k) const;
+    // 小于 k 的结点个数，即 lowerBound(k) 在中序中的下标。O(log n)
+    template <class K>
+    size_t rank(const K& k) const;
+    // 结点在中序中的下标。O(log n)
+    size_t indexOf(const Node* node) const;
+
+    // 查找 k 的插入位置：已存在等价结点时返回该结点；否则返回 NULL，
+    // 并由 parent、isLeft 给出新结点应挂接的位置，交给 link 使用。
+    template <class K>
+    Node* findSlot(const K& k, Node*& parent, bool& isLeft) const;
+    // 把 newNode 构造的结点挂到 parent 的左(右)孩子处并重新平衡
+    void link(Node* node, Node* parent, bool isLeft);
+    // 删除结点，返回它的后继结点
+    Node* erase(Node* node);
+
+    // 从内存池中分配结点并以 args 构造键值
+    template <class... Args>
+    Node* newNode(Args&&... args);
+    // 析构结点并归还给内存池
+    void deleteNode(Node* node);
+
+    // 交换两棵树，Compare 的交换不能抛出异常
+    void swap(RBTree& other) noexcept;
+
+    // ********************************************************
+    // *****************以下为 join、split 与集合运算*****************
+    // ********************************************************
+    //
+    // 这些操作在两棵树之间移动结点而不复制。两棵树的结点池不同时，
+    // 对方独占的结点池由本树整个接管；对方的结点池还被其他树共用
+    // （例如 split 得到的另一半）时，先把对方的结点逐个搬进本树的结点池，
+    // 额外花费 O(m) 的时间，m 为对方的结点个数。
+
+    // 把 key 与 right 的全部结点接到本树之后，right 变为空树。
+    // 要求本树的键 <= key <= right 的键。O(log n)
+    void join(const T& key, RBTree& right);
+    // 同上，不带中间的键
+    void join(RBTree& right);
+    // 把不小于 key 的结点（包括所有与 key 等价的结点）移到 right，
+    // right 原有的结点被释放，此后 right 与本树共用结点池。O(log^2 n)，Node 不维护子树大小时
+    // 还要数出较小一半的结点个数
+    template <class K>
+    void split(const K& key, RBTree& right);
+
+    // 集合运算，结果留在本树中，other 变为空树。两棵树都不应含有等价的键，
+    // 两棵树都有某个键时保留本树的结点。
+    // 把 other 按本树根结点的键拆成两半后递归，左右两半在不同线程中计算，
+    // 元素较少时串行执行。运算期间 Compare 不能抛出异常。
+    void union_with(RBTree& other);
+    void intersect_with(RBTree& other);
+    // 本树减去 other
+    void difference_with(RBTree& other);
+
   private:
-    // 前序遍历"红黑树"
-    void preOrder(RBTNode<T>* tree) const;
-    // 中序遍历"红黑树"
-    void inOrder(RBTNode<T>* tree) const;
-    // 后序遍历"红黑树"
-    void postOrder(RBTNode<T>* tree) const;
+    // 后序中 tree 子树的第一个结点
+    static Node* firstPostOrder(Node* tree);
+    // 按后序对 tree 子树中的每个结点调用 f(node)，f 可以释放该结点。
+    // 只在子树内移动，不访问 tree 的父结点。
+    template <class F>
+    static void postOrderNodes(Node* tree, F f);
 
-    // (递归实现)查找"红黑树x"中键值为key的节点
-    RBTNode<T>* search(RBTNode<T>* x, T key) const;
     // (非递归实现)查找"红黑树x"中键值为key的节点
-    RBTNode<T>* iterativeSearch(RBTNode<T>* x, T key) const;
+    Node* iterativeSearch(Node* x, T key) const;
 
     // 查找最小结点：返回tree为根结点的红黑树的最小结点。
-    RBTNode<T>* minimum(RBTNode<T>* tree);
+    Node* minimum(Node* tree) const;
     // 查找最大结点：返回tree为根结点的红黑树的最大结点。
-    RBTNode<T>* maximum(RBTNode<T>* tree);
+    Node* maximum(Node* tree) const;
 
     // 左旋
-    void leftRotate(RBTNode<T>*& root, RBTNode<T>* x);
+    void leftRotate(Node*& root, Node* x);
     // 右旋
-    void rightRotate(RBTNode<T>*& root, RBTNode<T>* y);
+    void rightRotate(Node*& root, Node* y);
     // 插入函数
-    void insert(RBTNode<T>*& root, RBTNode<T>* node);
+    void insert(Node*& root, Node* node);
     // 插入修正函数
-    void insertFixUp(RBTNode<T>*& root, RBTNode<T>* node);
+    void insertFixUp(Node*& root, Node* node);
     // 删除函数
-    void remove(RBTNode<T>*& root, RBTNode<T>* node);
+    void remove(Node*& root, Node* node);
     // 删除修正函数
-    void removeFixUp(RBTNode<T>*& root, RBTNode<T>* node, RBTNode<T>* parent);
+    void removeFixUp(Node*& root, Node* node, Node* parent);
 
     // 销毁红黑树
-    void destroy(RBTNode<T>*& tree);
+    void destroy(Node*& tree);
+
+    // 按中序把全部结点借用 left 指针串成单链表并返回表头，树随之置空
+    Node* unlinkAll();
+    // 由借用 right 指针串成的 n 个有序结点构造平衡的红黑树
+    void buildFromList(Node* head, size_t n);
+    // 结点是否维护子树大小，用于在两种实现之间分派
+    using countSize = std::integral_constant<bool, Node::countSize>;
+    // 子树的结点个数，空树为 0，要求 Node 维护子树大小
+    static size_t sizeOf(const Node* x) {
+        return x != NULL ? x->size : 0;
+    }
+    // split 后左半部分 l 的结点个数，两半共 n 个结点。维护子树大小时 O(1)；
+    // 否则同时从两半的最小结点向后走，O(较小一半的结点个数)。
+    size_t leftCount(Node* l, Node*, size_t, std::true_type) const {
+        return sizeOf(l);
+    }
+    size_t leftCount(Node* l, Node* r, size_t n, std::false_type) const;
+    // 集合运算据此决定是否分出线程：a、b 两棵子树的规模之和，
+    // 不能再分出线程时直接返回 0。维护子树大小时是准确值，
+    // 否则用黑高 h 给出的下界 2^h - 1，只需 O(log n)。
+    static size_t forkWeight(const Node* a, const Node* b, int forkDepth) {
+        if (forkDepth <= 0) return 0;
+        return weightOf(a, countSize()) + weightOf(b, countSize());
+    }
+    static size_t weightOf(const Node* x, std::true_type) { return sizeOf(x); }
+    static size_t weightOf(const Node* x, std::false_type) {
+        return (size_t(1) << blackHeight(x)) - 1;
+    }
+
+    // 用链表中接下来的 n 个结点构造根位于第 depth 层的子树，返回子树的根
+    static Node* buildSorted(Node*& cur, size_t n, int depth,
+                             int redDepth);
+
+    // 本树的结点池，尚未创建时先创建
+    pool_type& pool();
+    // 析构并归还整棵子树
+    void freeTree(Node* tree);
+    // 让 other 现有的结点改由本树的结点池管理，调用后 other 的结点必须全部
+    // 移入本树或释放。抛出异常时 other 不变
+    void adoptPool(RBTree& other);
+
+    // 以下结点级函数只操作传入的子树，不访问 mRoot，可以在多个线程中
+    // 同时处理互不相交的子树。传入、返回的子树都是独立的红黑树：
+    // 根的父结点为 NULL 且根为黑色。
+
+    // 子树的黑高，空树为 0。O(log n)
+    static int blackHeight(const Node* x);
+    // 把 x 从父结点上摘下作为独立的红黑树
+    static Node* detach(Node* x);
+    // 以结点 k 连接 l 与 r，要求 l 的键 <= k 的键 <= r 的键
+    Node* joinNodes(Node* l, Node* k, Node* r);
+    // 连接 l 与 r，要求 l 的键 <= r 的键
+    Node* concatNodes(Node* l, Node* r);
+    // 把 t 拆成小于 key 的 l、与 key 等价的结点 mid 和大于 key 的 r，
+    // 要求 t 中至多有一个与 key 等价的结点
+    template <class K>
+    void splitNodes(Node* t, const K& key, Node*& l,
+                    Node*& mid, Node*& r);
+    // 把 t 拆成小于 key 的 l 与不小于 key 的 r，t 中可以有等价的键
+    template <class K>
+    void splitNodes(Node* t, const K& key, Node*& l, Node*& r);
+    // 摘下 t 的最小结点并返回，其余结点构成 rest
+    Node* splitFirst(Node* t, Node*& rest);
+
+    // 集合运算中丢弃的子树，借用根的父结点指针串成链表，运算结束后统一释放
+    struct garbageList {
+        Node* head;
+        Node* tail;
+
+        garbageList() : head(NULL), tail(NULL) {}
+        void push(Node* x) {
+            if (x == NULL) return;
+            x->setParent(NULL);
+            if (tail != NULL)
+                tail->setParent(x);
+            else
+                head = x;
+            tail = x;
+        }
+        // 丢弃单个结点，它的孩子仍在使用
+        void pushNode(Node* x) {
+            x->left = x->right = NULL;
+            push(x);
+        }
+        void append(const garbageList& other) {
+            if (other.head == NULL) return;
+            if (tail != NULL)
+                tail->setParent(other.head);
+            else
+                head = other.head;
+            tail = other.tail;
+        }
+    };
+    using setOperation = Node* (RBTree::*)(Node*, Node*,
+                                           garbageList&, int);
+    // 以 op 合并本树与 other 的结点并释放丢弃的结点
+    void applySetOperation(RBTree& other, setOperation op);
+    // forkDepth 为还可以再分出线程的层数
+    Node* unionNodes(Node* a, Node* b, garbageList& g,
+                     int forkDepth);
+    Node* intersectNodes(Node* a, Node* b, garbageList& g,
+                         int forkDepth);
+    Node* differenceNodes(Node* a, Node* b, garbageList& g,
+                          int forkDepth);
+    // forkDepth > 0 且两棵子树足够大时在两个线程中分别执行 f(0) 与 f(1)
+    template <class F>
+    static void forkJoin(int forkDepth, size_t n, F f);
 
     // 打印红黑树
-    void print(RBTNode<T>* tree, T key, int direction);
+    void print(Node* tree, T key, int direction);
 
-#define rb_parent(r) ((r)->parent)
-#define rb_color(r) ((r)->color)
-#define rb_is_red(r) ((r)->color == RED)
-#define rb_is_black(r) ((r)->color == BLACK)
+#define rb_parent(r) ((r)->getParent())
+#define rb_color(r) ((r)->getColor())
+#define rb_is_red(r) ((r)->getColor() == RED)
+#define rb_is_black(r) ((r)->getColor() == BLACK)
 #define rb_set_black(r)                                                        \
-    do { (r)->color = BLACK; } while (0)
+    do { (r)->setColor(BLACK); } while (0)
 #define rb_set_red(r)                                                          \
-    do { (r)->color = RED; } while (0)
+    do { (r)->setColor(RED); } while (0)
 #define rb_set_parent(r, p)                                                    \
-    do { (r)->parent = (p); } while (0)
+    do { (r)->setParent(p); } while (0)
 #define rb_set_color(r, c)                                                     \
-    do { (r)->color = (c); } while (0)
+    do { (r)->setColor(c); } while (0)
 };
 
 /* 
  * 构造函数
  */
-template <class T>
-RBTree<T>::RBTree() : mRoot(NULL) {
-    mRoot = NULL;
-}
+template <class T, class Compare, class Node>
+RBTree<T, Compare, Node>::RBTree(const Compare& comp)
+        : RBTree(std::shared_ptr<pool_type>(), comp) {}
+
+template <class T, class Compare, class Node>
+RBTree<T, Compare, Node>::RBTree(std::shared_ptr<pool_type> pool,
+                                 const Compare&             comp)
+        : mRoot(NULL), mSize(0), mComp(comp), pool_(std::move(pool)) {}
 
 /* 
  * 析构函数
  */
-template <class T>
-RBTree<T>::~RBTree() {
+template <class T, class Compare, class Node>
+RBTree<T, Compare, Node>::~RBTree() {
     destroy();
 }
 
 /*
  * 前序遍历"红黑树"
+ *
+ * 访问完叶子后沿父指针向上，找到第一个右子树尚未访问的祖先。
  */
-template <class T>
-void RBTree<T>::preOrder(RBTNode<T>* tree) const {
-    if (tree != NULL) {
-        cout << tree->key << " ";
-        preOrder(tree->left);
-        preOrder(tree->right);
+template <class T, class Compare, class Node>
+template <class Visitor>
+void RBTree<T, Compare, Node>::preOrder(Visitor visit) const {
+    Node* x = mRoot;
+    while (x != NULL) {
+        visit(static_cast<const T&>(x->key));
+        if (x->left != NULL) {
+            x = x->left;
+        } else if (x->right != NULL) {
+            x = x->right;
+        } else {
+            Node* p = rb_parent(x);
+            while (p != NULL && (x == p->right || p->right == NULL)) {
+                x = p;
+                p = rb_parent(p);
+            }
+            x = p != NULL ? p->right : NULL;
+        }
     }
 }
 
-template <class T>
-void RBTree<T>::preOrder() {
-    preOrder(mRoot);
+template <class T, class Compare, class Node>
+void RBTree<T, Compare, Node>::preOrder() {
+    preOrder([](const T& key) { cout << key << " "; });
 }
 
 /*
  * 中序遍历"红黑树"
  */
-template <class T>
-void RBTree<T>::inOrder(RBTNode<T>* tree) const {
-    if (tree != NULL) {
-        inOrder(tree->left);
-        cout << tree->key << " ";
-        inOrder(tree->right);
+template <class T, class Compare, class Node>
+template <class Visitor>
+void RBTree<T, Compare, Node>::inOrder(Visitor visit) const {
+    for (Node* x = minimum(mRoot); x != NULL; x = successor(x)) {
+        visit(static_cast<const T&>(x->key));
     }
 }
 
-template <class T>
-void RBTree<T>::inOrder() {
-    inOrder(mRoot);
+template <class T, class Compare, class Node>
+template <class K1, class K2, class Visitor>
+void RBTree<T, Compare, Node>::inOrder(const K1& lo, const K2& hi,
+                                       Visitor visit) const {
+    Node* x = lowerBound(lo);
+    while (x != NULL && mComp(x->key, hi)) {
+        visit(static_cast<const T&>(x->key));
+        x = successor(x);
+    }
+}
+
+template <class T, class Compare, class Node>
+void RBTree<T, Compare, Node>::inOrder() {
+    inOrder([](const T& key) { cout << key << " "; });
 }
 
 /*
  * 后序遍历"红黑树"
  */
-template <class T>
-void RBTree<T>::postOrder(RBTNode<T>* tree) const {
-    if (tree != NULL) {
-        postOrder(tree->left);
-        postOrder(tree->right);
-        cout << tree->key << " ";
+template <class T, class Compare, class Node>
+template <class Visitor>
+void RBTree<T, Compare, Node>::postOrder(Visitor visit) const {
+    postOrderNodes(mRoot, [&visit](Node* x) {
+        visit(static_cast<const T&>(x->key));
+    });
+}
+
+template <class T, class Compare, class Node>
+void RBTree<T, Compare, Node>::postOrder() {
+    postOrder([](const T& key) { cout << key << " "; });
+}
+
+/*
+ * 后序中的第一个结点：一路向下，有左孩子走左孩子，否则走右孩子。
+ */
+template <class T, class Compare, class Node>
+Node* RBTree<T, Compare, Node>::firstPostOrder(Node* tree) {
+    while (tree->left != NULL || tree->right != NULL) {
+        tree = tree->left != NULL ? tree->left : tree->right;
     }
+    return tree;
 }
 
-template <class T>
-void RBTree<T>::postOrder() {
-    postOrder(mRoot);
+/*
+ * 后序遍历结点
+ *
+ * x 的后继：x 是左孩子且父结点有右子树时为右子树的后序首结点，否则为父结点。
+ * 先求出后继再调用 f，因此 f 可以析构、释放 x。
+ */
+template <class T, class Compare, class Node>
+template <class F>
+void RBTree<T, Compare, Node>::postOrderNodes(Node* tree, F f) {
+    if (tree == NULL) return;
+
+    Node* x = firstPostOrder(tree);
+    for (;;) {
+        Node* next = NULL;
+        if (x != tree) {
+            Node* p = rb_parent(x);
+            next = (x == p->left && p->right != NULL) ? firstPostOrder(p->right)
+                                                      : p;
+        }
+        f(x);
+        if (next == NULL) return;
+        x = next;
+    }
 }
 
 /*
- * (递归实现)查找"红黑树x"中键值为key的节点
+ * 分批导出的游标
+ *
+ * 每次 next 按升序把至多 n 个键值复制到 out，返回复制的个数，
+ * 可以把很大的树分段导出而不必一次全部复制出来。
  */
-template <class T>
-RBTNode<T>* RBTree<T>::search(RBTNode<T>* x, T key) const {
-    if (x == NULL || x->key == key) return x;
+template <class T, class Compare, class Node>
+class RBTree<T, Compare, Node>::cursor {
+    friend class RBTree;
 
-    if (key < x->key)
-        return search(x->left, key);
-    else
-        return search(x->right, key);
+    const RBTree* tree_;
+    Node*         node_;    // 下一个要输出的结点
+    Node*         end_;     // 区间之后的第一个结点，NULL 表示直到最大结点
+
+    cursor(const RBTree* tree, Node* first, Node* end)
+            : tree_(tree), node_(first), end_(end) {}
+
+  public:
+    bool done() const { return node_ == end_; }
+
+    template <class OutputIterator>
+    size_t next(OutputIterator out, size_t n) {
+        size_t i = 0;
+        for (; i != n && node_ != end_; ++i) {
+            *out++ = node_->key;
+            node_  = tree_->successor(node_);
+        }
+        return i;
+    }
+};
+
+template <class T, class Compare, class Node>
+typename RBTree<T, Compare, Node>::cursor
+RBTree<T, Compare, Node>::scan() const {
+    return cursor(this, minimum(mRoot), NULL);
+}
+
+template <class T, class Compare, class Node>
+template <class K1, class K2>
+typename RBTree<T, Compare, Node>::cursor
+RBTree<T, Compare, Node>::scan(const K1& lo, const K2& hi) const {
+    Node* first = lowerBound(lo);
+    // lo 不小于 hi 时为空区间
+    if (first == NULL || !mComp(first->key, hi)) {
+        return cursor(this, NULL, NULL);
+    }
+    return cursor(this, first, lowerBound(hi));
 }
 
-template <class T>
-RBTNode<T>* RBTree<T>::search(T key) {
-    search(mRoot, key);
+template <class T, class Compare, class Node>
+Node* RBTree<T, Compare, Node>::search(T key) {
+    return iterativeSearch(mRoot, key);
 }
 
 /*
  * (非递归实现)查找"红黑树x"中键值为key的节点
  */
-template <class T>
-RBTNode<T>* RBTree<T>::iterativeSearch(RBTNode<T>* x, T key) const {
-    while ((x != NULL) && (x->key != key)) {
-        if (key < x->key)
+template <class T, class Compare, class Node>
+Node* RBTree<T, Compare, Node>::iterativeSearch(Node* x, T key) const {
+    while (x != NULL) {
+        if (mComp(key, x->key))
             x = x->left;
-        else
+        else if (mComp(x->key, key))
             x = x->right;
+        else
+            break;
     }
 
     return x;
 }
 
-template <class T>
-RBTNode<T>* RBTree<T>::iterativeSearch(T key) {
-    iterativeSearch(mRoot, key);
+template <class T, class Compare, class Node>
+Node* RBTree<T, Compare, Node>::iterativeSearch(T key) {
+    return iterativeSearch(mRoot, key);
 }
 
 /* 
  * 查找最小结点：返回tree为根结点的红黑树的最小结点。
  */
-template <class T>
-RBTNode<T>* RBTree<T>::minimum(RBTNode<T>* tree) {
+template <class T, class Compare, class Node>
+Node* RBTree<T, Compare, Node>::minimum(Node* tree) const {
     if (tree == NULL) return NULL;
 
     while (tree->left != NULL) tree = tree->left;
     return tree;
 }
 
-template <class T>
-T RBTree<T>::minimum() {
-    RBTNode<T>* p = minimum(mRoot);
+template <class T, class Compare, class Node>
+T RBTree<T, Compare, Node>::minimum() {
+    Node* p = minimum(mRoot);
     if (p != NULL) return p->key;
 
     return (T)NULL;
@@ -243,17 +694,17 @@ T RBTree<T>::minimum() {
 /* 
  * 查找最大结点：返回tree为根结点的红黑树的最大结点。
  */
-template <class T>
-RBTNode<T>* RBTree<T>::maximum(RBTNode<T>* tree) {
+template <class T, class Compare, class Node>
+Node* RBTree<T, Compare, Node>::maximum(Node* tree) const {
     if (tree == NULL) return NULL;
 
     while (tree->right != NULL) tree = tree->right;
     return tree;
 }
 
-template <class T>
-T RBTree<T>::maximum() {
-    RBTNode<T>* p = maximum(mRoot);
+template <class T, class Compare, class Node>
+T RBTree<T, Compare, Node>::maximum() {
+    Node* p = maximum(mRoot);
     if (p != NULL) return p->key;
 
     return (T)NULL;
@@ -262,18 +713,18 @@ T RBTree<T>::maximum() {
 /* 
  * 找结点(x)的后继结点。即，查找"红黑树中数据值大于该结点"的"最小结点"。
  */
-template <class T>
-RBTNode<T>* RBTree<T>::successor(RBTNode<T>* x) {
+template <class T, class Compare, class Node>
+Node* RBTree<T, Compare, Node>::successor(Node* x) const {
     // 如果x存在右孩子，则"x的后继结点"为 "以其右孩子为根的子树的最小结点"。
     if (x->right != NULL) return minimum(x->right);
 
     // 如果x没有右孩子。则x有以下两种可能：
     // (01) x是"一个左孩子"，则"x的后继结点"为 "它的父结点"。
     // (02) x是"一个右孩子"，则查找"x的最低的父结点，并且该父结点要具有左孩子"，找到的这个"最低的父结点"就是"x的后继结点"。
-    RBTNode<T>* y = x->parent;
+    Node* y = rb_parent(x);
     while ((y != NULL) && (x == y->right)) {
         x = y;
-        y = y->parent;
+        y = rb_parent(y);
     }
 
     return y;
@@ -282,18 +733,18 @@ RBTNode<T>* RBTree<T>::successor(RBTNode<T>* x) {
 /* 
  * 找结点(x)的前驱结点。即，查找"红黑树中数据值小于该结点"的"最大结点"。
  */
-template <class T>
-RBTNode<T>* RBTree<T>::predecessor(RBTNode<T>* x) {
+template <class T, class Compare, class Node>
+Node* RBTree<T, Compare, Node>::predecessor(Node* x) const {
     // 如果x存在左孩子，则"x的前驱结点"为 "以其左孩子为根的子树的最大结点"。
     if (x->left != NULL) return maximum(x->left);
 
     // 如果x没有左孩子。则x有以下两种可能：
     // (01) x是"一个右孩子"，则"x的前驱结点"为 "它的父结点"。
     // (01) x是"一个左孩子"，则查找"x的最低的父结点，并且该父结点要具有右孩子"，找到的这个"最低的父结点"就是"x的前驱结点"。
-    RBTNode<T>* y = x->parent;
+    Node* y = rb_parent(x);
     while ((y != NULL) && (x == y->left)) {
         x = y;
-        y = y->parent;
+        y = rb_parent(y);
     }
 
     return y;
@@ -313,34 +764,38 @@ RBTNode<T>* RBTree<T>::predecessor(RBTNode<T>* x) {
  *
  *
  */
-template <class T>
-void RBTree<T>::leftRotate(RBTNode<T>*& root, RBTNode<T>* x) {
+template <class T, class Compare, class Node>
+void RBTree<T, Compare, Node>::leftRotate(Node*& root, Node* x) {
     // 设置x的右孩子为y
-    RBTNode<T>* y = x->right;
+    Node* y = x->right;
 
     // 将 “y的左孩子” 设为 “x的右孩子”；
     // 如果y的左孩子非空，将 “x” 设为 “y的左孩子的父亲”
-    x->right                             = y->left;
-    if (y->left != NULL) y->left->parent = x;
+    x->right = y->left;
+    if (y->left != NULL) rb_set_parent(y->left, x);
 
     // 将 “x的父亲” 设为 “y的父亲”
-    y->parent = x->parent;
+    rb_set_parent(y, rb_parent(x));
 
-    if (x->parent == NULL) {
+    if (rb_parent(x) == NULL) {
         root = y;    // 如果 “x的父亲” 是空节点，则将y设为根节点
     } else {
-        if (x->parent->left == x)
-            x->parent->left =
+        if (rb_parent(x)->left == x)
+            rb_parent(x)->left =
                     y;    // 如果 x是它父节点的左孩子，则将y设为“x的父节点的左孩子”
         else
-            x->parent->right =
+            rb_parent(x)->right =
                     y;    // 如果 x是它父节点的左孩子，则将y设为“x的父节点的左孩子”
     }
 
     // 将 “x” 设为 “y的左孩子”
     y->left = x;
     // 将 “x的父节点” 设为 “y”
-    x->parent = y;
+    rb_set_parent(x, y);
+
+    // x 的孩子变了，先重新计算 x 的子树大小，再计算它的新父结点 y
+    x->updateSize();
+    y->updateSize();
 }
 
 /* 
@@ -356,27 +811,27 @@ void RBTree<T>::leftRotate(RBTNode<T>*& root, RBTNode<T>* x) {
  *      lx  rx                                rx  ry
  * 
  */
-template <class T>
-void RBTree<T>::rightRotate(RBTNode<T>*& root, RBTNode<T>* y) {
+template <class T, class Compare, class Node>
+void RBTree<T, Compare, Node>::rightRotate(Node*& root, Node* y) {
     // 设置x是当前节点的左孩子。
-    RBTNode<T>* x = y->left;
+    Node* x = y->left;
 
     // 将 “x的右孩子” 设为 “y的左孩子”；
     // 如果"x的右孩子"不为空的话，将 “y” 设为 “x的右孩子的父亲”
-    y->left                                = x->right;
-    if (x->right != NULL) x->right->parent = y;
+    y->left = x->right;
+    if (x->right != NULL) rb_set_parent(x->right, y);
 
     // 将 “y的父亲” 设为 “x的父亲”
-    x->parent = y->parent;
+    rb_set_parent(x, rb_parent(y));
 
-    if (y->parent == NULL) {
+    if (rb_parent(y) == NULL) {
         root = x;    // 如果 “y的父亲” 是空节点，则将x设为根节点
     } else {
-        if (y == y->parent->right)
-            y->parent->right =
+        if (y == rb_parent(y)->right)
+            rb_parent(y)->right =
                     x;    // 如果 y是它父节点的右孩子，则将x设为“y的父节点的右孩子”
         else
-            y->parent->left =
+            rb_parent(y)->left =
                     x;    // (y是它父节点的左孩子) 将x设为“x的父节点的左孩子”
     }
 
@@ -384,7 +839,11 @@ void RBTree<T>::rightRotate(RBTNode<T>*& root, RBTNode<T>* y) {
     x->right = y;
 
     // 将 “y的父节点” 设为 “x”
-    y->parent = x;
+    rb_set_parent(y, x);
+
+    // y 的孩子变了，先重新计算 y 的子树大小，再计算它的新父结点 x
+    y->updateSize();
+    x->updateSize();
 }
 
 /*
@@ -397,9 +856,9 @@ void RBTree<T>::rightRotate(RBTNode<T>*& root, RBTNode<T>* y) {
  *     root 红黑树的根
  *     node 插入的结点        // 对应《算法导论》中的z
  */
-template <class T>
-void RBTree<T>::insertFixUp(RBTNode<T>*& root, RBTNode<T>* node) {
-    RBTNode<T>*parent, *gparent;
+template <class T, class Compare, class Node>
+void RBTree<T, Compare, Node>::insertFixUp(Node*& root, Node* node) {
+    Node *parent, *gparent;
 
     // 若“父节点存在，并且父节点的颜色是红色”
     while ((parent = rb_parent(node)) && rb_is_red(parent)) {
@@ -409,7 +868,7 @@ void RBTree<T>::insertFixUp(RBTNode<T>*& root, RBTNode<T>* node) {
         if (parent == gparent->left) {
             // Case 1条件：叔叔节点是红色
             {
-                RBTNode<T>* uncle = gparent->right;
+                Node* uncle = gparent->right;
                 if (uncle && rb_is_red(uncle)) {
                     rb_set_black(uncle);
                     rb_set_black(parent);
@@ -421,7 +880,7 @@ void RBTree<T>::insertFixUp(RBTNode<T>*& root, RBTNode<T>* node) {
 
             // Case 2条件：叔叔是黑色，且当前节点是右孩子
             if (parent->right == node) {
-                RBTNode<T>* tmp;
+                Node* tmp;
                 leftRotate(root, parent);
                 tmp    = parent;
                 parent = node;
@@ -436,7 +895,7 @@ void RBTree<T>::insertFixUp(RBTNode<T>*& root, RBTNode<T>* node) {
         {
             // Case 1条件：叔叔节点是红色
             {
-                RBTNode<T>* uncle = gparent->left;
+                Node* uncle = gparent->left;
                 if (uncle && rb_is_red(uncle)) {
                     rb_set_black(uncle);
                     rb_set_black(parent);
@@ -448,7 +907,7 @@ void RBTree<T>::insertFixUp(RBTNode<T>*& root, RBTNode<T>* node) {
 
             // Case 2条件：叔叔是黑色，且当前节点是左孩子
             if (parent->left == node) {
-                RBTNode<T>* tmp;
+                Node* tmp;
                 rightRotate(root, parent);
                 tmp    = parent;
                 parent = node;
@@ -473,23 +932,25 @@ void RBTree<T>::insertFixUp(RBTNode<T>*& root, RBTNode<T>* node) {
  *     root 红黑树的根结点
  *     node 插入的结点        // 对应《算法导论》中的node
  */
-template <class T>
-void RBTree<T>::insert(RBTNode<T>*& root, RBTNode<T>* node) {
-    RBTNode<T>* y = NULL;
-    RBTNode<T>* x = root;
+template <class T, class Compare, class Node>
+void RBTree<T, Compare, Node>::insert(Node*& root, Node* node) {
+    Node* y = NULL;
+    Node* x = root;
 
     // 1. 将红黑树当作一颗二叉查找树，将节点添加到二叉查找树中。
+    //    沿途的结点都会多一个子孙。
     while (x != NULL) {
         y = x;
-        if (node->key < x->key)
+        x->addSize(1);
+        if (mComp(node->key, x->key))
             x = x->left;
         else
             x = x->right;
     }
 
-    node->parent = y;
+    rb_set_parent(node, y);
     if (y != NULL) {
-        if (node->key < y->key)
+        if (mComp(node->key, y->key))
             y->left = node;
         else
             y->right = node;
@@ -497,7 +958,7 @@ void RBTree<T>::insert(RBTNode<T>*& root, RBTNode<T>* node) {
         root = node;
 
     // 2. 设置节点的颜色为红色
-    node->color = RED;
+    rb_set_red(node);
 
     // 3. 将它重新修正为一颗二叉查找树
     insertFixUp(root, node);
@@ -510,14 +971,10 @@ void RBTree<T>::insert(RBTNode<T>*& root, RBTNode<T>* node) {
  *     tree 红黑树的根结点
  *     key 插入结点的键值
  */
-template <class T>
-void RBTree<T>::insert(T key) {
-    RBTNode<T>* z = NULL;
-
-    // 如果新建结点失败，则返回。
-    if ((z = new RBTNode<T>(key, BLACK, NULL, NULL, NULL)) == NULL) return;
-
-    insert(mRoot, z);
+template <class T, class Compare, class Node>
+void RBTree<T, Compare, Node>::insert(T key) {
+    insert(mRoot, newNode(key));
+    ++mSize;
 }
 
 /*
@@ -530,10 +987,10 @@ void RBTree<T>::insert(T key) {
  *     root 红黑树的根
  *     node 待修正的节点
  */
-template <class T>
-void RBTree<T>::removeFixUp(RBTNode<T>*& root, RBTNode<T>* node,
-                            RBTNode<T>* parent) {
-    RBTNode<T>* other;
+template <class T, class Compare, class Node>
+void RBTree<T, Compare, Node>::removeFixUp(Node*& root, Node* node,
+                                           Node* parent) {
+    Node* other;
 
     while ((!node || rb_is_black(node)) && node != root) {
         if (parent->left == node) {
@@ -610,16 +1067,16 @@ void RBTree<T>::removeFixUp(RBTNode<T>*& root, RBTNode<T>* node,
  *     root 红黑树的根结点
  *     node 删除的结点
  */
-template <class T>
-void RBTree<T>::remove(RBTNode<T>*& root, RBTNode<T>* node) {
-    RBTNode<T>*child, *parent;
+template <class T, class Compare, class Node>
+void RBTree<T, Compare, Node>::remove(Node*& root, Node* node) {
+    Node *child, *parent;
     RBTColor   color;
 
     // 被删除节点的"左右孩子都不为空"的情况。
     if ((node->left != NULL) && (node->right != NULL)) {
         // 被删节点的后继节点。(称为"取代节点")
         // 用它来取代"被删节点"的位置，然后再将"被删节点"去掉。
-        RBTNode<T>* replace = node;
+        Node* replace = node;
 
         // 获取后继节点
         replace                               = replace->right;
@@ -635,6 +1092,12 @@ void RBTree<T>::remove(RBTNode<T>*& root, RBTNode<T>* node) {
             // "node节点"是根节点，更新根节点。
             root = replace;
 
+        // "取代节点"从原位置摘下，它的祖先(包括node)都少一个子孙
+        if (Node::countSize) {
+            for (Node* p = rb_parent(replace); p != NULL; p = rb_parent(p))
+                p->subSize(1);
+        }
+
         // child是"取代节点"的右孩子，也是需要"调整的节点"。
         // "取代节点"肯定不存在左孩子！因为它是一个后继节点。
         child  = replace->right;
@@ -654,14 +1117,15 @@ void RBTree<T>::remove(RBTNode<T>*& root, RBTNode<T>* node) {
             rb_set_parent(node->right, replace);
         }
 
-        replace->parent    = node->parent;
-        replace->color     = node->color;
-        replace->left      = node->left;
-        node->left->parent = replace;
+        rb_set_parent(replace, rb_parent(node));
+        rb_set_color(replace, rb_color(node));
+        replace->left = node->left;
+        rb_set_parent(node->left, replace);
+        replace->updateSize();
 
         if (color == BLACK) removeFixUp(root, child, parent);
 
-        delete node;
+        deleteNode(node);
         return;
     }
 
@@ -670,11 +1134,15 @@ void RBTree<T>::remove(RBTNode<T>*& root, RBTNode<T>* node) {
     else
         child = node->right;
 
-    parent = node->parent;
+    parent = rb_parent(node);
     // 保存"取代节点"的颜色
-    color = node->color;
+    color = rb_color(node);
+
+    if (Node::countSize) {
+        for (Node* p = parent; p != NULL; p = rb_parent(p)) p->subSize(1);
+    }
 
-    if (child) child->parent = parent;
+    if (child) rb_set_parent(child, parent);
 
     // "node节点"不是根节点
     if (parent) {
@@ -686,7 +1154,7 @@ void RBTree<T>::remove(RBTNode<T>*& root, RBTNode<T>* node) {
         root = child;
 
     if (color == BLACK) removeFixUp(root, child, parent);
-    delete node;
+    deleteNode(node);
 }
 
 /* 
@@ -695,31 +1163,812 @@ void RBTree<T>::remove(RBTNode<T>*& root, RBTNode<T>* node) {
  * 参数说明：
  *     tree 红黑树的根结点
  */
-template <class T>
-void RBTree<T>::remove(T key) {
-    RBTNode<T>* node;
+template <class T, class Compare, class Node>
+void RBTree<T, Compare, Node>::remove(T key) {
+    Node* node;
 
     // 查找key对应的节点(node)，找到的话就删除该节点
-    if ((node = search(mRoot, key)) != NULL) remove(mRoot, node);
+    if ((node = iterativeSearch(mRoot, key)) != NULL) {
+        remove(mRoot, node);
+        --mSize;
+    }
 }
 
 /*
- * 销毁红黑树
+ * 用有序区间重建红黑树
+ *
+ * 先按顺序构造结点并用 right 指针串成链表，再由 buildFromList 一次建成，
+ * 比逐个 insert 少了每次从根查找以及 insertFixUp 的旋转。
  */
-template <class T>
-void RBTree<T>::destroy(RBTNode<T>*& tree) {
-    if (tree == NULL) return;
+template <class T, class Compare, class Node>
+template <class InputIterator>
+void RBTree<T, Compare, Node>::assign_sorted(InputIterator first,
+                                             InputIterator last, bool unique) {
+    destroy();
 
-    if (tree->left != NULL) return destroy(tree->left);
-    if (tree->right != NULL) return destroy(tree->right);
+    Node*  head = NULL;
+    Node** tail = &head;
+    Node*  prev = NULL;
+    size_t n    = 0;
+    try {
+        for (; first != last; ++first) {
+            Node* node = newNode(*first);
+            if (prev != NULL && !mComp(prev->key, node->key)) {
+                assert(!mComp(node->key, prev->key) && "输入区间必须有序");
+                if (unique) {
+                    deleteNode(node);
+                    continue;
+                }
+            }
+            *tail = prev = node;
+            tail         = &node->right;
+            ++n;
+        }
+    } catch (...) {
+        *tail = NULL;
+        while (head != NULL) {
+            Node* next = head->right;
+            deleteNode(head);
+            head = next;
+        }
+        throw;
+    }
+    *tail = NULL;
+    buildFromList(head, n);
+}
 
-    delete tree;
+/*
+ * 批量插入
+ *
+ * 新结点全部构造完成后才改动树，构造时抛出异常则树保持不变。
+ */
+template <class T, class Compare, class Node>
+template <class InputIterator>
+void RBTree<T, Compare, Node>::insert_range(InputIterator first,
+                                            InputIterator last, bool unique) {
+    std::vector<Node*> nodes;
+    try {
+        for (; first != last; ++first) {
+            nodes.push_back(NULL);
+            nodes.back() = newNode(*first);
+        }
+    } catch (...) {
+        for (Node* node : nodes)
+            if (node != NULL) deleteNode(node);
+        throw;
+    }
+    if (nodes.empty()) return;
+
+    const Compare& comp = mComp;
+    std::stable_sort(nodes.begin(), nodes.end(),
+                     [&comp](const Node* a, const Node* b) {
+                         return comp(a->key, b->key);
+                     });
+
+    // 归并两个有序序列，等价时已有结点在前，与逐个 insert 的顺序一致
+    Node*  old  = unlinkAll();
+    Node*  head = NULL;
+    Node** tail = &head;
+    Node*  prev = NULL;
+    size_t n    = 0;
+    auto   it   = nodes.begin();
+    while (old != NULL || it != nodes.end()) {
+        Node* node;
+        if (it == nodes.end()
+            || (old != NULL && !mComp((*it)->key, old->key))) {
+            node = old;
+            old  = old->left;
+        } else {
+            node = *it++;
+        }
+        if (unique && prev != NULL && !mComp(prev->key, node->key)) {
+            deleteNode(node);
+            continue;
+        }
+        *tail = prev = node;
+        tail         = &node->right;
+        ++n;
+    }
+    *tail = NULL;
+    buildFromList(head, n);
+}
+
+/*
+ * 按中序把全部结点串成链表
+ *
+ * 求 x 的后继只会用到 x 右子树中结点的 left 指针以及祖先的 right 指针，
+ * 因此可以在遍历的同时改写已访问结点的 left 指针。
+ */
+template <class T, class Compare, class Node>
+Node* RBTree<T, Compare, Node>::unlinkAll() {
+    Node* head = minimum(mRoot);
+    for (Node* x = head; x != NULL;) {
+        Node* next = successor(x);
+        x->left          = next;
+        x                = next;
+    }
+    mRoot = NULL;
+    mSize = 0;
+    return head;
+}
+
+/*
+ * 由有序链表构造红黑树
+ *
+ * 每个结点左右子树的大小至多相差 1，因此深度小于 h = floor(log2(n + 1))
+ * 的各层都是满的，剩余结点全部位于第 h 层。前 h 层染黑、第 h 层染红，
+ * 每条路径恰好经过 h 个黑结点，且红结点的父结点都是黑色。
+ */
+template <class T, class Compare, class Node>
+void RBTree<T, Compare, Node>::buildFromList(Node* head, size_t n) {
+    int redDepth = 0;
+    for (size_t m = n + 1; m > 1; m >>= 1) ++redDepth;
+
+    mRoot = buildSorted(head, n, 0, redDepth);
+    if (mRoot != NULL) rb_set_parent(mRoot, NULL);
+    mSize = n;
+}
+
+template <class T, class Compare, class Node>
+Node* RBTree<T, Compare, Node>::buildSorted(Node*& cur, size_t n,
+                                            int depth, int redDepth) {
+    if (n == 0) return NULL;
+
+    const size_t leftSize = (n - 1) / 2;
+    Node*        left     = buildSorted(cur, leftSize, depth + 1, redDepth);
+    Node*        node     = cur;
+    cur                   = cur->right;
+    node->left            = left;
+    node->right = buildSorted(cur, n - 1 - leftSize, depth + 1, redDepth);
+
+    if (node->left != NULL) rb_set_parent(node->left, node);
+    if (node->right != NULL) rb_set_parent(node->right, node);
+    rb_set_color(node, depth == redDepth ? RED : BLACK);
+    node->setSize(n);
+    return node;
+}
+
+/*
+ * 销毁红黑树
+ *
+ * 只析构结点中的键值，结点内存由 destroy() 通过内存池整块释放。
+ */
+template <class T, class Compare, class Node>
+void RBTree<T, Compare, Node>::destroy(Node*& tree) {
+    postOrderNodes(tree, [](Node* x) { x->~Node(); });
     tree = NULL;
 }
 
-template <class T>
-void RBTree<T>::destroy() {
-    destroy(mRoot);
+template <class T, class Compare, class Node>
+void RBTree<T, Compare, Node>::destroy() {
+    if (pool_.use_count() == 1) {
+        // 结点池只属于本树：键值可平凡析构时不需要遍历，直接释放整个内存池。
+        if (!std::is_trivially_destructible<T>::value) destroy(mRoot);
+        pool_->release();
+    } else {
+        // 结点池与其他树共用，只能逐个归还
+        freeTree(mRoot);
+    }
+    mRoot = NULL;
+    mSize = 0;
+}
+
+template <class T, class Compare, class Node>
+typename RBTree<T, Compare, Node>::pool_type& RBTree<T, Compare, Node>::pool() {
+    if (pool_ == nullptr) pool_ = std::make_shared<pool_type>();
+    return *pool_;
+}
+
+template <class T, class Compare, class Node>
+void RBTree<T, Compare, Node>::freeTree(Node* tree) {
+    postOrderNodes(tree, [this](Node* x) { deleteNode(x); });
+}
+
+/*
+ * 从内存池中分配并构造结点
+ */
+template <class T, class Compare, class Node>
+template <class... Args>
+Node* RBTree<T, Compare, Node>::newNode(Args&&... args) {
+    Node* node = pool().allocate();
+    try {
+        ::new (static_cast<void*>(node))
+                Node(BLACK, std::forward<Args>(args)...);
+    } catch (...) {
+        pool_->deallocate(node);
+        throw;
+    }
+    return node;
+}
+
+/*
+ * 析构结点并归还给内存池
+ */
+template <class T, class Compare, class Node>
+void RBTree<T, Compare, Node>::deleteNode(Node* node) {
+    node->~Node();
+    pool_->deallocate(node);
+}
+
+/*
+ * 第一个不小于 k 的结点
+ */
+template <class T, class Compare, class Node>
+template <class K>
+Node* RBTree<T, Compare, Node>::lowerBound(const K& k) const {
+    Node* x   = mRoot;
+    Node* res = NULL;
+    while (x != NULL) {
+        if (mComp(x->key, k)) {
+            x = x->right;
+        } else {
+            res = x;
+            x   = x->left;
+        }
+    }
+    return res;
+}
+
+/*
+ * 第一个大于 k 的结点
+ */
+template <class T, class Compare, class Node>
+template <class K>
+Node* RBTree<T, Compare, Node>::upperBound(const K& k) const {
+    Node* x   = mRoot;
+    Node* res = NULL;
+    while (x != NULL) {
+        if (mComp(k, x->key)) {
+            res = x;
+            x   = x->left;
+        } else {
+            x = x->right;
+        }
+    }
+    return res;
+}
+
+template <class T, class Compare, class Node>
+template <class K>
+Node* RBTree<T, Compare, Node>::find(const K& k) const {
+    Node* x = lowerBound(k);
+    return (x != NULL && !mComp(k, x->key)) ? x : NULL;
+}
+
+/*
+ * 第 k 小的结点：左子树有 l 个结点时，k < l 在左子树中，k == l 即为当前结点，
+ * 否则在右子树中找第 k - l - 1 小的结点。
+ */
+template <class T, class Compare, class Node>
+Node* RBTree<T, Compare, Node>::select(size_t k) const {
+    static_assert(Node::countSize, "select requires a size-counting node");
+    Node* x = mRoot;
+    while (x != NULL) {
+        const size_t l = sizeOf(x->left);
+        if (k < l) {
+            x = x->left;
+        } else if (k == l) {
+            return x;
+        } else {
+            k -= l + 1;
+            x = x->right;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * 小于 k 的结点个数：每次向右走时，当前结点及其左子树都小于 k。
+ */
+template <class T, class Compare, class Node>
+template <class K>
+size_t RBTree<T, Compare, Node>::rank(const K& k) const {
+    static_assert(Node::countSize, "rank requires a size-counting node");
+    Node*  x = mRoot;
+    size_t r = 0;
+    while (x != NULL) {
+        if (mComp(x->key, k)) {
+            r += sizeOf(x->left) + 1;
+            x = x->right;
+        } else {
+            x = x->left;
+        }
+    }
+    return r;
+}
+
+template <class T, class Compare, class Node>
+size_t RBTree<T, Compare, Node>::indexOf(const Node* node) const {
+    static_assert(Node::countSize, "indexOf requires a size-counting node");
+    size_t r = sizeOf(node->left);
+    for (const Node* p = rb_parent(node); p != NULL;
+         node = p, p = rb_parent(p)) {
+        if (node == p->right) r += sizeOf(p->left) + 1;
+    }
+    return r;
+}
+
+/*
+ * 查找 k 的插入位置，只比较不构造结点
+ */
+template <class T, class Compare, class Node>
+template <class K>
+Node* RBTree<T, Compare, Node>::findSlot(const K& k, Node*& parent,
+                                         bool& isLeft) const {
+    Node* x = mRoot;
+    Node* y = NULL;    // 最后一次向右走时经过的结点，k 可能与它等价
+    parent        = NULL;
+    isLeft        = true;
+    while (x != NULL) {
+        parent = x;
+        isLeft = mComp(k, x->key);
+        if (isLeft) {
+            x = x->left;
+        } else {
+            y = x;
+            x = x->right;
+        }
+    }
+    // 此时 y 是不大于 k 的最大结点
+    if (y != NULL && !mComp(y->key, k)) return y;
+    return NULL;
+}
+
+/*
+ * 把结点挂到 findSlot 给出的位置并重新平衡
+ */
+template <class T, class Compare, class Node>
+void RBTree<T, Compare, Node>::link(Node* node, Node* parent,
+                                    bool isLeft) {
+    node->left = node->right = NULL;
+    node->setSize(1);
+    if (Node::countSize) {
+        for (Node* p = parent; p != NULL; p = rb_parent(p)) p->addSize(1);
+    }
+
+    rb_set_parent(node, parent);
+    if (parent == NULL)
+        mRoot = node;
+    else if (isLeft)
+        parent->left = node;
+    else
+        parent->right = node;
+
+    rb_set_red(node);
+    insertFixUp(mRoot, node);
+    ++mSize;
+}
+
+/*
+ * 删除结点并返回它的后继
+ */
+template <class T, class Compare, class Node>
+Node* RBTree<T, Compare, Node>::erase(Node* node) {
+    // remove 用后继结点本身替换被删结点，后继结点的地址保持不变
+    Node* next = successor(node);
+    remove(mRoot, node);
+    --mSize;
+    return next;
+}
+
+template <class T, class Compare, class Node>
+void RBTree<T, Compare, Node>::swap(RBTree& other) noexcept {
+    std::swap(mRoot, other.mRoot);
+    std::swap(mSize, other.mSize);
+    std::swap(mComp, other.mComp);
+    std::swap(pool_, other.pool_);
+}
+
+template <class T, class Compare, class Node>
+void RBTree<T, Compare, Node>::adoptPool(RBTree& other) {
+    if (pool_ == other.pool_ || other.mRoot == NULL) return;
+    if (other.pool_.use_count() == 1) {
+        // 此后 other 的结点都由本池管理，other 保留已经变空的原结点池
+        pool().merge(*other.pool_);
+        return;
+    }
+
+    // other 的结点池还有其他树在用，整个接管会让那些树的结点随本池释放。
+    // 改为在本池中为 other 的每个键值分配新结点，旧结点归还给 other 的池。
+    // 先分配全部结点，移动键值时才不会因为分配失败而丢失已移走的键值。
+    std::vector<Node*> nodes;
+    try {
+        nodes.reserve(other.mSize);
+        for (size_t i = 0; i < other.mSize; ++i)
+            nodes.push_back(pool().allocate());
+    } catch (...) {
+        for (Node* node : nodes) pool_->deallocate(node);
+        throw;
+    }
+
+    size_t built = 0;
+    Node*  head  = NULL;
+    Node** tail  = &head;
+    try {
+        for (Node* x = minimum(other.mRoot); x != NULL; x = successor(x)) {
+            Node* node = nodes[built];
+            ::new (static_cast<void*>(node))
+                    Node(BLACK, std::move_if_noexcept(x->key));
+            ++built;
+            *tail = node;
+            tail  = &node->right;
+        }
+    } catch (...) {
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            if (i < built) nodes[i]->~Node();
+            pool_->deallocate(nodes[i]);
+        }
+        throw;
+    }
+
+    const size_t n = other.mSize;
+    other.destroy();
+    other.buildFromList(head, n);
+}
+
+template <class T, class Compare, class Node>
+void RBTree<T, Compare, Node>::join(const T& key, RBTree& right) {
+    assert(mRoot == NULL || !mComp(key, maximum(mRoot)->key));
+    assert(right.mRoot == NULL || !mComp(minimum(right.mRoot)->key, key));
+    Node* k = newNode(key);    // 先分配，抛出异常时两棵树都不变
+    try {
+        adoptPool(right);
+    } catch (...) {
+        deleteNode(k);
+        throw;
+    }
+    mRoot       = joinNodes(mRoot, k, right.mRoot);
+    mSize       = mSize + 1 + right.mSize;
+    right.mRoot = NULL;
+    right.mSize = 0;
+}
+
+template <class T, class Compare, class Node>
+void RBTree<T, Compare, Node>::join(RBTree& right) {
+    assert(mRoot == NULL || right.mRoot == NULL
+           || !mComp(minimum(right.mRoot)->key, maximum(mRoot)->key));
+    adoptPool(right);
+    mRoot       = concatNodes(mRoot, right.mRoot);
+    mSize       = mSize + right.mSize;
+    right.mRoot = NULL;
+    right.mSize = 0;
+}
+
+template <class T, class Compare, class Node>
+template <class K>
+void RBTree<T, Compare, Node>::split(const K& key, RBTree& right) {
+    if (&right == this) return;
+    right.destroy();
+    right.pool_ = pool_;
+    right.mComp = mComp;
+
+    Node *l, *r;
+    splitNodes(mRoot, key, l, r);
+    const size_t n = mSize;
+    mRoot          = l;
+    mSize          = leftCount(l, r, n, countSize());
+    right.mRoot    = r;
+    right.mSize    = n - mSize;
+}
+
+template <class T, class Compare, class Node>
+size_t RBTree<T, Compare, Node>::leftCount(Node* l, Node* r, size_t n,
+                                           std::false_type) const {
+    size_t steps = 0;
+    for (l = minimum(l), r = minimum(r); l != NULL && r != NULL; ++steps) {
+        l = successor(l);
+        r = successor(r);
+    }
+    // 先走完的一半恰好有 steps 个结点
+    return l == NULL ? steps : n - steps;
+}
+
+template <class T, class Compare, class Node>
+void RBTree<T, Compare, Node>::union_with(RBTree& other) {
+    if (&other == this) return;
+    applySetOperation(other, &RBTree::unionNodes);
+}
+
+template <class T, class Compare, class Node>
+void RBTree<T, Compare, Node>::intersect_with(RBTree& other) {
+    if (&other == this) return;
+    applySetOperation(other, &RBTree::intersectNodes);
+}
+
+template <class T, class Compare, class Node>
+void RBTree<T, Compare, Node>::difference_with(RBTree& other) {
+    if (&other == this) {
+        destroy();
+        return;
+    }
+    applySetOperation(other, &RBTree::differenceNodes);
+}
+
+/*
+ * 集合运算的公共部分
+ *
+ * 丢弃的结点先记在各线程自己的 garbageList 中，并行部分结束后
+ * 才在当前线程归还给结点池，因为结点池不是线程安全的。
+ */
+template <class T, class Compare, class Node>
+void RBTree<T, Compare, Node>::applySetOperation(RBTree&      other,
+                                                 setOperation op) {
+    adoptPool(other);
+
+    // 可以再分出线程的层数：共 2^forkDepth 个线程，不超过 chunkCount 给出的块数
+    const size_t   n = mSize + other.mSize;
+    const unsigned k = extrastl::parallel::detail::chunkCount(n);
+    int            forkDepth = 0;
+    while ((1u << forkDepth) < k) ++forkDepth;
+
+    garbageList g;
+    mRoot       = (this->*op)(mRoot, other.mRoot, g, forkDepth);
+    other.mRoot = NULL;
+    other.mSize = 0;
+
+    // 两棵树的结点不是留在结果中就是被丢弃，结果的大小由丢弃的个数得出
+    size_t freed = 0;
+    for (Node* x = g.head; x != NULL;) {
+        Node* next = rb_parent(x);
+        postOrderNodes(x, [this, &freed](Node* y) {
+            deleteNode(y);
+            ++freed;
+        });
+        x = next;
+    }
+    mSize = n - freed;
+}
+
+template <class T, class Compare, class Node>
+template <class F>
+void RBTree<T, Compare, Node>::forkJoin(int forkDepth, size_t n, F f) {
+    if (forkDepth > 0 && n >= extrastl::parallel::SERIAL_THRESHOLD) {
+        extrastl::parallel::detail::forEachChunk(
+                2, 2, [&f](unsigned i, size_t, size_t) { f(i); });
+    } else {
+        f(0);
+        f(1);
+    }
+}
+
+template <class T, class Compare, class Node>
+Node* RBTree<T, Compare, Node>::unionNodes(Node* a, Node* b,
+                                           garbageList& g, int forkDepth) {
+    if (a == NULL) return b;
+    if (b == NULL) return a;
+
+    const size_t n  = forkWeight(a, b, forkDepth);
+    Node*        l1 = detach(a->left);
+    Node*        r1 = detach(a->right);
+    Node *l2, *mid, *r2;
+    splitNodes(b, a->key, l2, mid, r2);
+    if (mid != NULL) g.pushNode(mid);
+
+    Node* res[2];
+    garbageList gs[2];
+    forkJoin(forkDepth, n, [&](unsigned i) {
+        res[i] = i == 0 ? unionNodes(l1, l2, gs[0], forkDepth - 1)
+                        : unionNodes(r1, r2, gs[1], forkDepth - 1);
+    });
+    g.append(gs[0]);
+    g.append(gs[1]);
+    return joinNodes(res[0], a, res[1]);
+}
+
+template <class T, class Compare, class Node>
+Node* RBTree<T, Compare, Node>::intersectNodes(Node* a, Node* b,
+                                               garbageList& g,
+                                               int          forkDepth) {
+    if (a == NULL || b == NULL) {
+        g.push(a);
+        g.push(b);
+        return NULL;
+    }
+
+    const size_t n  = forkWeight(a, b, forkDepth);
+    Node*        l1 = detach(a->left);
+    Node*        r1 = detach(a->right);
+    Node *l2, *mid, *r2;
+    splitNodes(b, a->key, l2, mid, r2);
+
+    Node* res[2];
+    garbageList gs[2];
+    forkJoin(forkDepth, n, [&](unsigned i) {
+        res[i] = i == 0 ? intersectNodes(l1, l2, gs[0], forkDepth - 1)
+                        : intersectNodes(r1, r2, gs[1], forkDepth - 1);
+    });
+    g.append(gs[0]);
+    g.append(gs[1]);
+    if (mid != NULL) {
+        g.pushNode(mid);
+        return joinNodes(res[0], a, res[1]);
+    }
+    g.pushNode(a);
+    return concatNodes(res[0], res[1]);
+}
+
+template <class T, class Compare, class Node>
+Node* RBTree<T, Compare, Node>::differenceNodes(Node* a, Node* b,
+                                                garbageList& g,
+                                                int          forkDepth) {
+    if (a == NULL) {
+        g.push(b);
+        return NULL;
+    }
+    if (b == NULL) return a;
+
+    // 这里按 b 的根拆分 a，a 中与之等价的结点被丢弃
+    const size_t n  = forkWeight(a, b, forkDepth);
+    Node*        l2 = detach(b->left);
+    Node*        r2 = detach(b->right);
+    Node *l1, *mid, *r1;
+    splitNodes(a, b->key, l1, mid, r1);
+    g.pushNode(b);
+    if (mid != NULL) g.pushNode(mid);
+
+    Node* res[2];
+    garbageList gs[2];
+    forkJoin(forkDepth, n, [&](unsigned i) {
+        res[i] = i == 0 ? differenceNodes(l1, l2, gs[0], forkDepth - 1)
+                        : differenceNodes(r1, r2, gs[1], forkDepth - 1);
+    });
+    g.append(gs[0]);
+    g.append(gs[1]);
+    return concatNodes(res[0], res[1]);
+}
+
+template <class T, class Compare, class Node>
+int RBTree<T, Compare, Node>::blackHeight(const Node* x) {
+    int h = 0;
+    for (; x != NULL; x = x->left)
+        if (rb_is_black(x)) ++h;
+    return h;
+}
+
+template <class T, class Compare, class Node>
+Node* RBTree<T, Compare, Node>::detach(Node* x) {
+    if (x != NULL) x->setParentAndColor(NULL, BLACK);
+    return x;
+}
+
+/*
+ * 以结点 k 连接 l 与 r
+ *
+ * 黑高相同时 k 直接作为黑色的根。否则以 l 较高为例：沿 l 的右链向下找到
+ * 黑高与 r 相同的黑结点 c，用红色的 k 取代 c 的位置，c 与 r 作为 k 的
+ * 左右孩子。此时只可能在 k 与其父结点之间出现连续的红结点，
+ * 与插入一个红结点的情形相同，交给 insertFixUp 修正。
+ * 代价与两棵树的黑高之差成正比，另有求黑高的 O(log n)。
+ */
+template <class T, class Compare, class Node>
+Node* RBTree<T, Compare, Node>::joinNodes(Node* l, Node* k,
+                                          Node* r) {
+    l            = detach(l);
+    r            = detach(r);
+    const int hl = blackHeight(l);
+    const int hr = blackHeight(r);
+
+    if (hl == hr) {
+        k->left  = l;
+        k->right = r;
+        k->setParentAndColor(NULL, BLACK);
+        if (l != NULL) rb_set_parent(l, k);
+        if (r != NULL) rb_set_parent(r, k);
+        k->updateSize();
+        return k;
+    }
+
+    Node* root = hl > hr ? l : r;
+    Node* p    = NULL;
+    Node* c    = root;
+    int       h    = hl > hr ? hl : hr;
+    const int goal = hl > hr ? hr : hl;
+    while (!(h == goal && (c == NULL || rb_is_black(c)))) {
+        if (rb_is_black(c)) --h;
+        p = c;
+        c = hl > hr ? c->right : c->left;
+    }
+
+    if (hl > hr) {
+        k->left  = c;
+        k->right = r;
+        p->right = k;
+    } else {
+        k->left  = l;
+        k->right = c;
+        p->left  = k;
+    }
+    k->setParentAndColor(p, RED);
+    if (k->left != NULL) rb_set_parent(k->left, k);
+    if (k->right != NULL) rb_set_parent(k->right, k);
+    k->updateSize();
+
+    // p 及其祖先多了 k 与较矮的那棵树，自下而上重新计算
+    if (Node::countSize) {
+        for (Node* x = p; x != NULL; x = rb_parent(x)) x->updateSize();
+    }
+
+    insertFixUp(root, k);
+    return root;
+}
+
+template <class T, class Compare, class Node>
+Node* RBTree<T, Compare, Node>::concatNodes(Node* l, Node* r) {
+    if (r == NULL) return l;
+    if (l == NULL) return r;
+    Node* rest;
+    Node* k = splitFirst(r, rest);
+    return joinNodes(l, k, rest);
+}
+
+/*
+ * 拆分子树
+ *
+ * 从根向 key 所在的位置走，路径左侧的子树依次连接成 l，右侧的连接成 r。
+ */
+template <class T, class Compare, class Node>
+template <class K>
+void RBTree<T, Compare, Node>::splitNodes(Node* t, const K& key,
+                                          Node*& l, Node*& mid,
+                                          Node*& r) {
+    if (t == NULL) {
+        l = mid = r = NULL;
+        return;
+    }
+    Node* tl = detach(t->left);
+    Node* tr = detach(t->right);
+    if (mComp(key, t->key)) {
+        Node* rr;
+        splitNodes(tl, key, l, mid, rr);
+        r = joinNodes(rr, t, tr);
+    } else if (mComp(t->key, key)) {
+        Node* ll;
+        splitNodes(tr, key, ll, mid, r);
+        l = joinNodes(tl, t, ll);
+    } else {
+        l   = tl;
+        mid = t;
+        r   = tr;
+    }
+}
+
+/*
+ * 按下界拆分子树：不小于 key 的结点都归 r，与 key 等价的结点可能出现在
+ * 路径两侧，因此不能在遇到第一个等价结点时停下。
+ */
+template <class T, class Compare, class Node>
+template <class K>
+void RBTree<T, Compare, Node>::splitNodes(Node* t, const K& key, Node*& l,
+                                          Node*& r) {
+    if (t == NULL) {
+        l = r = NULL;
+        return;
+    }
+    Node* tl = detach(t->left);
+    Node* tr = detach(t->right);
+    if (mComp(t->key, key)) {
+        Node* ll;
+        splitNodes(tr, key, ll, r);
+        l = joinNodes(tl, t, ll);
+    } else {
+        Node* rr;
+        splitNodes(tl, key, l, rr);
+        r = joinNodes(rr, t, tr);
+    }
+}
+
+template <class T, class Compare, class Node>
+Node* RBTree<T, Compare, Node>::splitFirst(Node* t, Node*& rest) {
+    Node* tl = detach(t->left);
+    Node* tr = detach(t->right);
+    if (tl == NULL) {
+        rest = tr;
+        return t;
+    }
+    Node* rr;
+    Node* first = splitFirst(tl, rr);
+    rest              = joinNodes(rr, t, tr);
+    return first;
 }
 
 /*
@@ -730,8 +1979,8 @@ void RBTree<T>::destroy() {
  *               -1，表示该节点是它的父结点的左孩子;
  *                1，表示该节点是它的父结点的右孩子。
  */
-template <class T>
-void RBTree<T>::print(RBTNode<T>* tree, T key, int direction) {
+template <class T, class Compare, class Node>
+void RBTree<T, Compare, Node>::print(Node* tree, T key, int direction) {
     if (tree != NULL) {
         if (direction == 0)    // tree是根节点
             cout << setw(2) << tree->key << "(B) is root" << endl;
@@ -745,8 +1994,8 @@ void RBTree<T>::print(RBTNode<T>* tree, T key, int direction) {
     }
 }
 
-template <class T>
-void RBTree<T>::print() {
+template <class T, class Compare, class Node>
+void RBTree<T, Compare, Node>::print() {
     if (mRoot != NULL) print(mRoot, mRoot->key, 0);
 }
 }
@@ -0,0 +1,274 @@
+#ifndef EXTRASTL_RBTREE_IMAGE_H
+#define EXTRASTL_RBTREE_IMAGE_H
+
+#include "rbTree.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+namespace extrastl {
+namespace detail {
+
+// 映像文件头，之后紧跟按中序排列的全部键值
+struct rbTreeImageHeader {
+    char     magic[8];         // "RBTIMAGE"
+    uint32_t version;          // 格式版本
+    uint32_t byteOrder;        // 写入方的 0x01020304，用于检查字节序
+    uint32_t keySize;          // sizeof(T)
+    uint32_t keyAlign;         // alignof(T)
+    uint64_t count;            // 键值个数
+    char     reserved[32];     // 填充到 64 字节，键值从缓存行边界开始
+};
+
+static_assert(sizeof(rbTreeImageHeader) == 64, "image header must be 64 bytes");
+
+const char RBTREE_IMAGE_MAGIC[8] = {'R', 'B', 'T', 'I', 'M', 'A', 'G', 'E'};
+const uint32_t RBTREE_IMAGE_VERSION   = 1;
+const uint32_t RBTREE_IMAGE_BYTEORDER = 0x01020304;
+
+template <class T>
+rbTreeImageHeader makeImageHeader(uint64_t count) {
+    rbTreeImageHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, RBTREE_IMAGE_MAGIC, sizeof(h.magic));
+    h.version   = RBTREE_IMAGE_VERSION;
+    h.byteOrder = RBTREE_IMAGE_BYTEORDER;
+    h.keySize   = sizeof(T);
+    h.keyAlign  = alignof(T);
+    h.count     = count;
+    return h;
+}
+}    // namespace detail
+
+/*
+ * 把红黑树写成映像文件
+ *
+ * 先写入 path.tmp 并 fsync，成功后再改名为 path，写入过程中失败或崩溃
+ * 不会破坏已有的映像，正在映射旧文件的进程也不受影响。
+ * 失败时抛出 std::system_error。
+ */
+template <class T, class Compare, class Node>
+void writeImage(const RBTree<T, Compare, Node>& tree,
+                const std::string&             path) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "RBTreeImage requires trivially copyable keys");
+    static_assert(alignof(T) <= sizeof(detail::rbTreeImageHeader),
+                  "key alignment exceeds the image header size");
+
+    const std::string tmp  = path + ".tmp";
+    std::FILE*        file = std::fopen(tmp.c_str(), "wb");
+    if (file == NULL) {
+        throw std::system_error(errno, std::generic_category(), tmp);
+    }
+
+    int  err = 0;
+    auto put = [&err, file](const void* p, size_t bytes) {
+        if (err == 0 && bytes != 0 && std::fwrite(p, 1, bytes, file) != bytes) {
+            err = errno != 0 ? errno : EIO;
+        }
+    };
+
+    try {
+        const detail::rbTreeImageHeader header =
+                detail::makeImageHeader<T>(tree.size());
+        put(&header, sizeof(header));
+
+        // 按中序分批写出，避免每个键一次 fwrite
+        std::vector<T> buffer;
+        buffer.reserve(4096);
+        tree.inOrder([&](const T& key) {
+            buffer.push_back(key);
+            if (buffer.size() == buffer.capacity()) {
+                put(buffer.data(), buffer.size() * sizeof(T));
+                buffer.clear();
+            }
+        });
+        put(buffer.data(), buffer.size() * sizeof(T));
+    } catch (...) {
+        std::fclose(file);
+        std::remove(tmp.c_str());
+        throw;
+    }
+
+    if (err == 0 && (std::fflush(file) != 0 || ::fsync(fileno(file)) != 0)) {
+        err = errno;
+    }
+    if (std::fclose(file) != 0 && err == 0) err = errno;
+    if (err == 0 && std::rename(tmp.c_str(), path.c_str()) != 0) err = errno;
+    if (err == 0) return;
+
+    std::remove(tmp.c_str());
+    throw std::system_error(err, std::generic_category(), path);
+}
+
+// RBTree 的只读映像文件：64 字节的文件头之后是按中序排列的全部键值。
+//
+// 文件中不含指针，结点之间的关系由下标隐含：第 i 个键的后继是第 i + 1 个，
+// 查找是在有序数组上二分，比较次数不超过红黑树的高度。因此文件可以直接
+// mmap 后查询，不需要反序列化或重新插入；多个进程映射同一个文件时
+// 通过页缓存共用一份内存。
+//
+//     extrastl::writeImage(tree, "index.img");        // 生成映像
+//     extrastl::RBTreeImage<Key> index("index.img");  // 重启后直接映射
+//     const Key* k = index.search(key);
+//
+// 键值必须可平凡复制，映像只能在字长、字节序与 sizeof(T) 相同的机器上读取，
+// 打开时会校验文件头。
+//
+// RBTreeImage 以只读方式 mmap 映像文件并直接查询，接口与 RBTree 的只读部分
+// 相对应。结点就是映像中的键值，用指向键值的指针表示，在映像析构前有效。
+template <class T, class Compare = std::less<T>>
+class RBTreeImage {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "RBTreeImage requires trivially copyable keys");
+
+  private:
+    void*    map_;      // 整个文件的映射
+    size_t   bytes_;    // 映射长度
+    const T* keys_;     // 有序键值数组
+    size_t   size_;
+    Compare  comp_;
+
+  public:
+    // 打开并校验映像文件，失败时抛出 std::system_error（系统调用失败）
+    // 或 std::runtime_error（文件格式不符）。
+    explicit RBTreeImage(const std::string& path,
+                         const Compare&     comp = Compare())
+            : map_(NULL), bytes_(0), keys_(NULL), size_(0), comp_(comp) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), path);
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            const int err = errno;
+            ::close(fd);
+            throw std::system_error(err, std::generic_category(), path);
+        }
+        bytes_ = static_cast<size_t>(st.st_size);
+        if (bytes_ < sizeof(detail::rbTreeImageHeader)) {
+            ::close(fd);
+            throw std::runtime_error(path + ": not an RBTree image");
+        }
+        map_ = ::mmap(NULL, bytes_, PROT_READ, MAP_SHARED, fd, 0);
+        const int err = errno;
+        ::close(fd);    // 映射建立后不再需要文件描述符
+        if (map_ == MAP_FAILED) {
+            map_ = NULL;
+            throw std::system_error(err, std::generic_category(), path);
+        }
+
+        const auto* h = static_cast<const detail::rbTreeImageHeader*>(map_);
+        const char* error = validate(*h);
+        if (error != NULL) {
+            ::munmap(map_, bytes_);
+            throw std::runtime_error(path + ": " + error);
+        }
+        keys_ = reinterpret_cast<const T*>(h + 1);
+        size_ = static_cast<size_t>(h->count);
+    }
+    RBTreeImage(const RBTreeImage&) = delete;
+    RBTreeImage& operator=(const RBTreeImage&) = delete;
+    ~RBTreeImage() {
+        if (map_ != NULL) ::munmap(map_, bytes_);
+    }
+
+    bool   empty() const { return size_ == 0; }
+    size_t size() const { return size_; }
+
+    // 有序键值数组，可以直接交给标准库算法
+    const T* begin() const { return keys_; }
+    const T* end() const { return keys_ + size_; }
+
+    // 最小、最大键值，空映像时返回 NULL
+    const T* first() const { return size_ != 0 ? keys_ : NULL; }
+    const T* last() const { return size_ != 0 ? keys_ + size_ - 1 : NULL; }
+    // 最小、最大键值，空映像时返回 T()
+    T minimum() const { return size_ != 0 ? keys_[0] : T(); }
+    T maximum() const { return size_ != 0 ? keys_[size_ - 1] : T(); }
+
+    // 后继、前驱，不存在时返回 NULL
+    const T* successor(const T* x) const {
+        return x + 1 != end() ? x + 1 : NULL;
+    }
+    const T* predecessor(const T* x) const { return x != keys_ ? x - 1 : NULL; }
+
+    // 第一个不小于 k、第一个大于 k 的键值，不存在时返回 NULL
+    template <class K>
+    const T* lowerBound(const K& k) const {
+        return orNull(std::lower_bound(begin(), end(), k, comp_));
+    }
+    template <class K>
+    const T* upperBound(const K& k) const {
+        return orNull(std::upper_bound(begin(), end(), k, comp_));
+    }
+    // 与 k 等价的第一个键值，不存在时返回 NULL
+    template <class K>
+    const T* search(const K& k) const {
+        const T* x = lowerBound(k);
+        return x != NULL && !comp_(k, *x) ? x : NULL;
+    }
+
+    // 第 k 小（从 0 开始计）的键值，k >= size() 时返回 NULL。O(1)
+    const T* select(size_t k) const { return k < size_ ? keys_ + k : NULL; }
+    // 小于 k 的键值个数
+    template <class K>
+    size_t rank(const K& k) const {
+        return std::lower_bound(begin(), end(), k, comp_) - begin();
+    }
+
+    // 按升序对每个键值、[lo, hi) 中的每个键值调用 visit(const T&)
+    template <class Visitor>
+    void inOrder(Visitor visit) const {
+        for (const T* x = begin(); x != end(); ++x) visit(*x);
+    }
+    template <class K1, class K2, class Visitor>
+    void inOrder(const K1& lo, const K2& hi, Visitor visit) const {
+        for (const T* x = std::lower_bound(begin(), end(), lo, comp_);
+             x != end() && comp_(*x, hi); ++x) {
+            visit(*x);
+        }
+    }
+
+  private:
+    const T* orNull(const T* x) const { return x != end() ? x : NULL; }
+
+    // 校验文件头，返回错误描述，通过时返回 NULL
+    const char* validate(const detail::rbTreeImageHeader& h) const {
+        if (std::memcmp(h.magic, detail::RBTREE_IMAGE_MAGIC, sizeof(h.magic))
+            != 0) {
+            return "not an RBTree image";
+        }
+        if (h.version != detail::RBTREE_IMAGE_VERSION) {
+            return "unsupported image version";
+        }
+        if (h.byteOrder != detail::RBTREE_IMAGE_BYTEORDER) {
+            return "image byte order does not match";
+        }
+        if (h.keySize != sizeof(T) || h.keyAlign != alignof(T)) {
+            return "image key type does not match";
+        }
+        const size_t payload = bytes_ - sizeof(h);
+        if (h.count > payload / sizeof(T) || h.count * sizeof(T) != payload) {
+            return "image size does not match its key count";
+        }
+        return NULL;
+    }
+};
+}    // namespace extrastl
+
+#endif
@@ -0,0 +1,384 @@
+#ifndef EXTRASTL_SMALL_VECTOR_H
+#define EXTRASTL_SMALL_VECTOR_H
+
+#include "vector.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace extrastl {
+
+// 前 N 个元素存放在对象内部的缓冲区中，超出 N 个后才转移到堆上。
+// 接口与 extrastl::vector 相同。
+//
+// 与 vector 不同，元素位于对象内部时移动与交换都需要逐个搬迁元素，
+// 因此只在元素个数通常不超过 N 的场景下使用。
+template <class T, size_t N, class Allocator = std::allocator<T>>
+class small_vector : private Allocator {
+    static_assert(N > 0, "small_vector 的内联容量 N 必须大于 0");
+
+  public:
+    using value_type      = T;
+    using iterator        = T*;
+    using const_iterator  = const T*;
+    using pointer         = iterator;
+    using reference       = T&;
+    using const_reference = const T&;
+    using size_type       = size_t;
+    using difference_type = ptrdiff_t;
+    using allocator_type  = Allocator;
+
+  private:
+    using allocTraits = std::allocator_traits<Allocator>;
+
+    T* start_;
+    T* finish_;
+    T* endOfStorage_;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type buffer_[N];
+
+  public:
+    // **************************************************************
+    // ************************构造函数*******************************
+    // **************************************************************
+    small_vector()
+            : start_(inlineData()), finish_(start_), endOfStorage_(start_ + N) {
+    }
+    explicit small_vector(const allocator_type& a)
+            : Allocator(a), start_(inlineData()), finish_(start_),
+              endOfStorage_(start_ + N) {}
+    explicit small_vector(const size_type       n,
+                          const allocator_type& a = allocator_type())
+            : small_vector(a) {
+        resize(n);
+    }
+    small_vector(const size_type n, const value_type& value,
+                 const allocator_type& a = allocator_type())
+            : small_vector(a) {
+        insert(end(), n, value);
+    }
+    small_vector(const size_type n, default_init_t,
+                 const allocator_type& a = allocator_type())
+            : small_vector(a) {
+        resize_for_overwrite(n);
+    }
+    template <class InputIterator>
+    small_vector(InputIterator first, InputIterator last,
+                 const allocator_type& a = allocator_type())
+            : small_vector(a) {
+        insert(end(), first, last);
+    }
+    small_vector(const small_vector& v)
+            : small_vector(allocTraits::select_on_container_copy_construction(
+                      v.allocRef())) {
+        insert(end(), v.begin(), v.end());
+    }
+    small_vector(small_vector&& v) : small_vector(std::move(v.allocRef())) {
+        moveFrom(v);
+    }
+
+    ~small_vector() {
+        destroy(start_, finish_);
+        deallocateHeap();
+    }
+
+    small_vector& operator=(const small_vector& v) {
+        if (this != &v) {
+            clear();
+            insert(end(), v.begin(), v.end());
+        }
+        return *this;
+    }
+    small_vector& operator=(small_vector&& v) {
+        if (this != &v) {
+            clear();
+            if (!v.isInline() && allocRef() == v.allocRef()) {
+                deallocateHeap();
+                start_  = inlineData();
+                finish_ = endOfStorage_ = start_;
+            }
+            moveFrom(v);
+        }
+        return *this;
+    }
+
+    allocator_type get_allocator() const { return allocRef(); }
+
+    // **************************************************************
+    // ***************************迭代器********************************
+    // **************************************************************
+    iterator       begin() { return (start_); }
+    const_iterator begin() const { return (start_); }
+    const_iterator cbegin() const { return (start_); }
+    iterator       end() { return (finish_); }
+    const_iterator end() const { return (finish_); }
+    const_iterator cend() const { return (finish_); }
+
+    // **************************************************************
+    // ***************************容量********************************
+    // **************************************************************
+    size_type size() const { return finish_ - start_; }
+    size_type capacity() const { return endOfStorage_ - start_; }
+    bool      empty() const { return start_ == finish_; }
+
+    // 调整 capacity 大小，不超过 N 时什么也不做。
+    void reserve(size_type n) {
+        if (n <= capacity()) return;
+        growTo(n);
+    }
+
+    // 元素个数不超过 N 时搬回内部缓冲区，否则重新分配一块 size 大小的堆空间。
+    void shrink_to_fit() {
+        if (isInline() || size() == capacity()) return;
+        if (size() > N) {
+            growTo(size());
+            return;
+        }
+        // 搬迁抛出异常时 uninitializedRelocate 已析构搬过去的元素
+        T* newFinish =
+                detail::uninitializedRelocate(start_, finish_, inlineData());
+        replaceStorage(inlineData(), newFinish, inlineData() + N);
+    }
+
+    // **************************************************************
+    // ************************元素访问*******************************
+    // **************************************************************
+    reference operator[](const difference_type i) { return *(begin() + i); }
+    const_reference operator[](const difference_type i) const {
+        return *(cbegin() + i);
+    }
+    reference front() { return *(begin()); }
+    reference back() { return *(end() - 1); }
+    pointer   data() { return start_; }
+
+    // **************************************************************
+    // ***************************修改********************************
+    // **************************************************************
+    void clear() {
+        destroy(start_, finish_);
+        finish_ = start_;
+    }
+
+    void swap(small_vector& v) {
+        if (this == &v) return;
+        if (!isInline() && !v.isInline()) {
+            using std::swap;
+            swap(allocRef(), v.allocRef());
+            std::swap(start_, v.start_);
+            std::swap(finish_, v.finish_);
+            std::swap(endOfStorage_, v.endOfStorage_);
+        } else {
+            small_vector temp(std::move(v));
+            v     = std::move(*this);
+            *this = std::move(temp);
+        }
+    }
+
+    void push_back(const value_type& value) { emplace_back(value); }
+    void push_back(value_type&& value) { emplace_back(std::move(value)); }
+
+    // 在尾部原地构造元素。只有空间已满时才转入 reallocateAndEmplaceBack。
+    template <class... Args>
+    reference emplace_back(Args&&... args) {
+        if (finish_ != endOfStorage_) {
+            allocTraits::construct(allocRef(), finish_,
+                                   std::forward<Args>(args)...);
+            ++finish_;
+        } else {
+            reallocateAndEmplaceBack(std::forward<Args>(args)...);
+        }
+        return back();
+    }
+
+    // 在 position 处原地构造元素，返回指向新元素的迭代器。
+    template <class... Args>
+    iterator emplace(const_iterator position, Args&&... args) {
+        const auto index = position - cbegin();
+        if (start_ + index == finish_) {
+            emplace_back(std::forward<Args>(args)...);
+        } else {
+            // 参数可能引用自身元素，先构造出临时对象再移动后部元素。
+            value_type temp(std::forward<Args>(args)...);
+            T*         pos = openGap(index, 1);
+            allocTraits::construct(allocRef(), pos, std::move(temp));
+        }
+        return start_ + index;
+    }
+
+    void pop_back() {
+        --finish_;
+        allocTraits::destroy(allocRef(), finish_);
+    }
+
+    iterator insert(iterator position, const value_type& val) {
+        return emplace(position, val);
+    }
+    iterator insert(iterator position, value_type&& val) {
+        return emplace(position, std::move(val));
+    }
+
+    void insert(iterator position, const size_type& n, const value_type& val) {
+        insert_aux(position, n, val,
+                   typename std::is_integral<size_type>::type());
+    }
+
+    template <class InputIterator>
+    void insert(iterator position, InputIterator first, InputIterator last) {
+        insert_aux(position, first, last,
+                   typename std::is_integral<InputIterator>::type());
+    }
+
+    void resize(size_type n, value_type val = value_type()) {
+        if (n < size()) {
+            destroy(start_ + n, finish_);
+            finish_ = start_ + n;
+        } else if (n > size()) {
+            insert(end(), n - size(), val);
+        }
+    }
+
+    // 与 vector::resize_for_overwrite 相同，新增元素只做默认初始化。
+    void resize_for_overwrite(size_type n) {
+        if (n < size()) {
+            destroy(start_ + n, finish_);
+            finish_ = start_ + n;
+        } else if (n > size()) {
+            if (n > capacity()) growTo(getNewCapacity(n - size()));
+            finish_ = detail::uninitializedDefaultInit(finish_, start_ + n);
+        }
+    }
+
+    iterator erase(iterator position) { return erase(position, position + 1); }
+    iterator erase(iterator first, iterator last) {
+        if (first == last) return first;
+        iterator newFinish = detail::shiftLeft(last, finish_, first);
+        destroy(newFinish, finish_);
+        finish_ = newFinish;
+        return (first);
+    }
+
+  private:
+    allocator_type&       allocRef() { return *this; }
+    const allocator_type& allocRef() const { return *this; }
+
+    T* inlineData() { return reinterpret_cast<T*>(buffer_); }
+    bool isInline() const {
+        return start_ == reinterpret_cast<const T*>(buffer_);
+    }
+
+    void destroy(T* first, T* last) {
+        for (; first != last; ++first) {
+            allocTraits::destroy(allocRef(), first);
+        }
+    }
+
+    void deallocateHeap() {
+        if (!isInline()) {
+            allocTraits::deallocate(allocRef(), start_, capacity());
+        }
+    }
+
+    // 接管 v 的元素，调用前 *this 必须为空。
+    // v 的元素在堆上且 *this 仍使用内部缓冲区时直接接管指针，否则逐个搬迁。
+    void moveFrom(small_vector& v) {
+        if (!v.isInline() && isInline() && allocRef() == v.allocRef()) {
+            start_          = v.start_;
+            finish_         = v.finish_;
+            endOfStorage_   = v.endOfStorage_;
+            v.start_        = v.inlineData();
+            v.finish_       = v.start_;
+            v.endOfStorage_ = v.start_ + N;
+        } else {
+            reserve(v.size());
+            finish_ = detail::uninitializedRelocate(v.start_, v.finish_,
+                                                    start_);
+            v.clear();
+        }
+    }
+
+    // 将元素搬迁到一块容量为 newCapacity 的新堆空间。
+    // 搬迁抛出异常时释放新空间，原有元素保持不变。
+    void growTo(size_type newCapacity) {
+        T* newStart = allocTraits::allocate(allocRef(), newCapacity);
+        T* newFinish;
+        try {
+            newFinish =
+                    detail::uninitializedRelocate(start_, finish_, newStart);
+        } catch (...) {
+            allocTraits::deallocate(allocRef(), newStart, newCapacity);
+            throw;
+        }
+        replaceStorage(newStart, newFinish, newStart + newCapacity);
+    }
+
+    // 析构原有元素、释放原有堆空间，改用已搬迁好元素的新空间。
+    void replaceStorage(T* newStart, T* newFinish, T* newEndOfStorage) {
+        destroy(start_, finish_);
+        deallocateHeap();
+        start_        = newStart;
+        finish_       = newFinish;
+        endOfStorage_ = newEndOfStorage;
+    }
+
+    // 在 index 处空出 n 个未初始化的位置（必要时扩容），返回空位的起始位置。
+    T* openGap(size_type index, size_type n) {
+        if (size() + n > capacity()) growTo(getNewCapacity(n));
+        T* pos = start_ + index;
+        detail::shiftRight(pos, finish_, n);
+        finish_ += n;
+        return pos;
+    }
+
+    template <class InputIterator>
+    void insert_aux(iterator position, InputIterator first, InputIterator last,
+                    std::false_type) {
+        const auto n = std::distance(first, last);
+        if (n == 0) return;
+        T* pos = openGap(position - start_, n);
+        std::uninitialized_copy(first, last, pos);
+    }
+
+    template <class Integer>
+    void insert_aux(iterator position, Integer n, const value_type& value,
+                    std::true_type) {
+        if (n == 0) return;
+        // value 可能引用自身元素，扩容或移动前先复制一份。
+        value_type temp(value);
+        T*         pos = openGap(position - start_, n);
+        std::uninitialized_fill_n(pos, n, temp);
+    }
+
+    // 空间已满时在尾部构造一个新元素：
+    // 先在新空间中构造新元素（参数可能引用自身元素），再搬迁旧元素。
+    // 任何一步抛出异常时析构新元素并释放新空间，原有元素保持不变。
+    template <class... Args>
+    void reallocateAndEmplaceBack(Args&&... args) {
+        const size_type newCapacity = getNewCapacity(1);
+        T* newStart  = allocTraits::allocate(allocRef(), newCapacity);
+        T* inserted  = newStart + size();
+        T* newFinish = inserted;    // 新元素的尾后位置
+        try {
+            allocTraits::construct(allocRef(), inserted,
+                                   std::forward<Args>(args)...);
+            newFinish = inserted + 1;
+            detail::uninitializedRelocate(start_, finish_, newStart);
+        } catch (...) {
+            destroy(inserted, newFinish);
+            allocTraits::deallocate(allocRef(), newStart, newCapacity);
+            throw;
+        }
+        replaceStorage(newStart, newFinish, newStart + newCapacity);
+    }
+
+    size_type getNewCapacity(size_type len) const {
+        size_type oldCapacity = endOfStorage_ - start_;
+        return oldCapacity + std::max(oldCapacity, len);
+    }
+
+};    // end of class small_vector
+}    // namespace extrastl
+
+#endif
@@ -0,0 +1,165 @@
+// AVLTree 与 std::multiset 的对照测试，并检查 AVL 树的结构：
+// 父指针、记录的高度以及任一结点左右子树的高度差不超过 1。
+#include "../avlTree.h"
+#include "check.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 检查以 x 为根的子树，返回结点个数，高度存入 height
+template <class T>
+size_t checkNodes(const extrastl::AVLTNode<T>* x,
+                  const extrastl::AVLTNode<T>* parent, int& height) {
+    if (x == NULL) {
+        height = 0;
+        return 0;
+    }
+    CHECK(x->parent == parent);
+    int          lh, rh;
+    const size_t n = checkNodes(x->left, x, lh) + checkNodes(x->right, x, rh)
+                     + 1;
+    CHECK(lh - rh <= 1 && rh - lh <= 1);
+    height = (lh > rh ? lh : rh) + 1;
+    CHECK(x->height == height);
+    return n;
+}
+
+template <class T, class Compare>
+void checkTree(const extrastl::AVLTree<T, Compare>& t,
+               const std::multiset<T, Compare>&    ref) {
+    const extrastl::AVLTNode<T>* root = t.first();
+    while (root != NULL && root->parent != NULL) root = root->parent;
+    int height;
+    CHECK(checkNodes(root, static_cast<decltype(root)>(NULL), height)
+          == ref.size());
+    CHECK(t.size() == ref.size());
+    // AVL 树的高度不超过 1.44 log2(n + 2)
+    CHECK(height <= 1.45 * std::log2(double(ref.size()) + 2));
+
+    std::vector<T> keys;
+    t.inOrder([&keys](const T& k) { keys.push_back(k); });
+    CHECK(std::equal(keys.begin(), keys.end(), ref.begin(), ref.end()));
+
+    // 从最大结点沿 predecessor 反向遍历
+    auto r = ref.rbegin();
+    for (auto* x = t.last(); x != NULL; x = t.predecessor(x), ++r) {
+        CHECK(r != ref.rend() && x->key == *r);
+    }
+    CHECK(r == ref.rend());
+}
+
+void testRandom(std::mt19937& rng) {
+    for (int round = 0; round < 20; ++round) {
+        extrastl::AVLTree<long> t;
+        std::multiset<long>     ref;
+        const long              range = round % 2 == 0 ? 50 : 5000;
+        for (int i = 0; i < 5000; ++i) {
+            const long k = rng() % range;
+            if (rng() % 3 != 0) {
+                t.insert(k);
+                ref.insert(k);
+            } else if (ref.count(k) != 0) {
+                t.remove(k);
+                ref.erase(ref.find(k));
+            }
+            if (i % 500 == 0) checkTree(t, ref);
+        }
+        checkTree(t, ref);
+        if (!ref.empty()) {
+            CHECK(t.minimum() == *ref.begin());
+            CHECK(t.maximum() == *ref.rbegin());
+        }
+        const long k = rng() % range;
+        CHECK((t.search(k) != NULL) == (ref.count(k) != 0));
+        CHECK(t.search(k) == t.iterativeSearch(k));
+
+        t.destroy();
+        checkTree(t, std::multiset<long>());
+    }
+}
+
+// 有序插入是旋转最多的情形
+void testSortedInsert() {
+    extrastl::AVLTree<long> t;
+    std::multiset<long>     ref;
+    for (long k = 0; k < 4096; ++k) {
+        t.insert(k);
+        ref.insert(k);
+    }
+    checkTree(t, ref);
+    for (long k = 0; k < 4096; k += 2) {
+        t.remove(k);
+        ref.erase(k);
+    }
+    checkTree(t, ref);
+}
+
+// 等价的键按插入顺序排列
+struct item {
+    int key;
+    int seq;
+
+    bool operator==(const item& other) const {
+        return key == other.key && seq == other.seq;
+    }
+};
+struct byKey {
+    bool operator()(const item& a, const item& b) const {
+        return a.key < b.key;
+    }
+};
+
+void testEqualKeysOrder(std::mt19937& rng) {
+    extrastl::AVLTree<item, byKey> t;
+    std::multiset<item, byKey>     ref;
+    for (int i = 0; i < 3000; ++i) {
+        const item x{int(rng() % 20), i};
+        t.insert(x);
+        ref.insert(x);
+    }
+    checkTree(t, ref);
+}
+
+// 不可平凡析构的键与共用的结点池，配合 -fsanitize=address 检查泄漏
+void testSharedPoolStrings(std::mt19937& rng) {
+    using tree = extrastl::AVLTree<std::string>;
+    auto pool  = std::make_shared<tree::pool_type>();
+    tree a(pool), b(pool);
+    std::multiset<std::string> ra, rb;
+    for (int i = 0; i < 2000; ++i) {
+        const std::string k = std::to_string(rng() % 500)
+                              + std::string(40, 'x');
+        tree&                       t = i % 2 == 0 ? a : b;
+        std::multiset<std::string>& r = i % 2 == 0 ? ra : rb;
+        if (rng() % 4 != 0) {
+            t.insert(k);
+            r.insert(k);
+        } else if (r.count(k) != 0) {
+            t.remove(k);
+            r.erase(r.find(k));
+        }
+    }
+    checkTree(a, ra);
+    checkTree(b, rb);
+    a.destroy();
+    checkTree(b, rb);
+}
+}    // namespace
+
+int main() {
+    std::mt19937 rng(24);
+    testRandom(rng);
+    testSortedInsert();
+    testEqualKeysOrder(rng);
+    testSharedPoolStrings(rng);
+    std::cout << "AVLTree ok" << std::endl;
+    return 0;
+}
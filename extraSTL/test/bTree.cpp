@@ -0,0 +1,142 @@
+// BTree 与 std::multiset 的对照测试。结点很小时每个结点只放 3 个元素，
+// 树很深，插入、删除会频繁地分裂、借用与合并结点。
+#include "../bTree.h"
+#include "check.h"
+
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+template <class Tree, class T>
+void checkSame(const Tree& t, const std::multiset<T>& ref) {
+    CHECK(t.size() == ref.size());
+    CHECK(t.empty() == ref.empty());
+    std::vector<T> keys;
+    t.inOrder([&keys](const T& k) { keys.push_back(k); });
+    CHECK(std::equal(keys.begin(), keys.end(), ref.begin(), ref.end()));
+    if (!ref.empty()) {
+        CHECK(t.minimum() == *ref.begin());
+        CHECK(t.maximum() == *ref.rbegin());
+    }
+}
+
+// 区间遍历与查找，要求 lo <= hi
+template <class Tree, class T>
+void checkLookup(const Tree& t, const std::multiset<T>& ref, const T& lo,
+                 const T& hi) {
+    std::vector<T> keys;
+    t.inOrder(lo, hi, [&keys](const T& k) { keys.push_back(k); });
+    CHECK(keys == std::vector<T>(ref.lower_bound(lo), ref.lower_bound(hi)));
+    const T* x = t.search(lo);
+    CHECK((x != nullptr) == (ref.count(lo) != 0));
+    if (x != nullptr) CHECK(*x == lo);
+}
+
+template <size_t NodeBytes>
+void testRandom(std::mt19937& rng) {
+    using tree = extrastl::BTree<long, std::less<long>, NodeBytes>;
+    for (int round = 0; round < 20; ++round) {
+        tree                t;
+        std::multiset<long> ref;
+        const long          range = round % 2 == 0 ? 50 : 5000;
+        for (int i = 0; i < 5000; ++i) {
+            const long k = rng() % range;
+            if (rng() % 3 != 0) {
+                t.insert(k);
+                ref.insert(k);
+            } else {
+                t.remove(k);
+                if (ref.count(k) != 0) ref.erase(ref.find(k));
+            }
+            if (i % 500 == 0) {
+                checkSame(t, ref);
+                const long lo = rng() % range;
+                checkLookup(t, ref, lo, lo + long(rng() % range));
+            }
+        }
+        checkSame(t, ref);
+
+        // 全部删除，包括逐层收缩到空树
+        std::vector<long> keys(ref.begin(), ref.end());
+        std::shuffle(keys.begin(), keys.end(), rng);
+        for (size_t i = 0; i < keys.size(); ++i) {
+            t.remove(keys[i]);
+            ref.erase(ref.find(keys[i]));
+            if (i % 256 == 0) checkSame(t, ref);
+        }
+        checkSame(t, ref);
+        t.insert(1);    // 清空后仍可使用
+        checkSame(t, std::multiset<long>{1});
+    }
+}
+
+// 等价的键按插入顺序排列
+struct item {
+    int key;
+    int seq;
+
+    bool operator==(const item& other) const {
+        return key == other.key && seq == other.seq;
+    }
+};
+struct byKey {
+    bool operator()(const item& a, const item& b) const {
+        return a.key < b.key;
+    }
+    bool operator()(const item& a, int k) const { return a.key < k; }
+    bool operator()(int k, const item& b) const { return k < b.key; }
+};
+
+void testEqualKeysOrder(std::mt19937& rng) {
+    extrastl::BTree<item, byKey, 64> t;
+    std::multiset<item, byKey>       ref;
+    for (int i = 0; i < 3000; ++i) {
+        const item x{int(rng() % 20), i};
+        t.insert(x);
+        ref.insert(x);
+    }
+    std::vector<item> keys;
+    t.inOrder([&keys](const item& x) { keys.push_back(x); });
+    CHECK(std::equal(keys.begin(), keys.end(), ref.begin(), ref.end()));
+    // 异构查找返回等价键中的第一个
+    const item* x = t.search(7);
+    CHECK(x != nullptr && *x == *ref.lower_bound(item{7, 0}));
+}
+
+// 不可平凡析构的键：删除、销毁时逐个析构，配合 -fsanitize=address 检查泄漏
+void testStrings(std::mt19937& rng) {
+    extrastl::BTree<std::string, std::less<std::string>, 128> t;
+    std::multiset<std::string>                                ref;
+    for (int i = 0; i < 3000; ++i) {
+        const std::string k = std::to_string(rng() % 1000)
+                              + std::string(40, 'x');
+        if (rng() % 4 != 0) {
+            t.insert(k);
+            ref.insert(k);
+        } else {
+            t.remove(k);
+            if (ref.count(k) != 0) ref.erase(ref.find(k));
+        }
+    }
+    checkSame(t, ref);
+    t.destroy();
+    checkSame(t, std::multiset<std::string>());
+    t.insert("again");
+    checkSame(t, std::multiset<std::string>{"again"});
+}
+}    // namespace
+
+int main() {
+    std::mt19937 rng(23);
+    testRandom<64>(rng);
+    testRandom<256>(rng);
+    testRandom<4096>(rng);
+    testEqualKeysOrder(rng);
+    testStrings(rng);
+    std::cout << "BTree ok" << std::endl;
+    return 0;
+}
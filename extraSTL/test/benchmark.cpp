@@ -0,0 +1,701 @@
+// extrastl 容器与标准库容器的性能对比。
+//
+// 不依赖 Google Benchmark，可离线编译运行：
+//     g++ -std=c++14 -O2 -pthread benchmark.cpp -o benchmark
+//     ./benchmark --filter=vector --min_time=0.5 --json=result.json
+//
+// 每个用例报告每次运行的耗时、每个元素的耗时以及每次运行的内存分配次数与字节数。
+// --json 输出的格式与 Google Benchmark 的 JSON 输出兼容，可直接用其 compare.py 做回归对比。
+
+#include "../algorithm.h"
+#include "../vector.h"
+#include "../list.h"
+#include "../unrolled_list.h"
+#include "../map.h"
+#include "../bTree.h"
+#include "../avlTree.h"
+#include "../rbTreeImage.h"
+#include "../bitmap.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <new>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+// **************************************************************
+// ***********************内存分配统计*****************************
+// **************************************************************
+namespace {
+std::atomic<size_t> allocCount(0);
+std::atomic<size_t> allocBytes(0);
+
+// 所有 new 与 delete 都经由这两个函数分配和释放。不允许内联，否则 g++ 会把
+// 内联进来的 free 与调用处的 new 配对，报 -Wmismatched-new-delete。
+__attribute__((noinline)) void* countedAlloc(size_t n) {
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    allocBytes.fetch_add(n, std::memory_order_relaxed);
+    void* p = std::malloc(n != 0 ? n : 1);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+__attribute__((noinline)) void countedFree(void* p) noexcept { std::free(p); }
+}    // namespace
+
+void* operator new(size_t n) { return countedAlloc(n); }
+void* operator new[](size_t n) { return countedAlloc(n); }
+void  operator delete(void* p) noexcept { countedFree(p); }
+void  operator delete[](void* p) noexcept { countedFree(p); }
+void  operator delete(void* p, size_t) noexcept { countedFree(p); }
+void  operator delete[](void* p, size_t) noexcept { countedFree(p); }
+
+namespace {
+
+// **************************************************************
+// ***************************框架********************************
+// **************************************************************
+
+// 阻止编译器把结果当作无用代码优化掉。
+template <class T>
+void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// 一个基准用例：setUp 在每次计时前调用且不计时，run 为计时部分，
+// tearDown 在用例全部运行结束后调用，用于释放数据。
+struct benchmarkCase {
+    std::string           name;
+    size_t                items;    // 每次运行处理的元素个数
+    std::function<void()> setUp;
+    std::function<void()> run;
+    std::function<void()> tearDown;
+};
+
+struct benchmarkResult {
+    std::string name;
+    size_t      iterations;
+    double      nsPerIteration;
+    double      itemsPerSecond;
+    double      allocsPerIteration;
+    double      bytesPerIteration;
+};
+
+std::vector<benchmarkCase>& registry() {
+    static std::vector<benchmarkCase> cases;
+    return cases;
+}
+
+void addCase(const std::string& name, size_t items, std::function<void()> run,
+             std::function<void()> setUp    = nullptr,
+             std::function<void()> tearDown = nullptr) {
+    registry().push_back(benchmarkCase{name, items, std::move(setUp),
+                                       std::move(run), std::move(tearDown)});
+}
+
+benchmarkResult runCase(const benchmarkCase& c, double minTime) {
+    using clock = std::chrono::steady_clock;
+
+    size_t iterations = 0, allocs = 0, bytes = 0;
+    double elapsed = 0;
+    while (elapsed < minTime || iterations == 0) {
+        if (c.setUp) c.setUp();
+        const size_t countBefore = allocCount.load();
+        const size_t bytesBefore = allocBytes.load();
+        const auto   start       = clock::now();
+        c.run();
+        elapsed += std::chrono::duration<double>(clock::now() - start).count();
+        allocs += allocCount.load() - countBefore;
+        bytes += allocBytes.load() - bytesBefore;
+        ++iterations;
+    }
+    if (c.tearDown) c.tearDown();
+
+    benchmarkResult r;
+    r.name               = c.name;
+    r.iterations         = iterations;
+    r.nsPerIteration     = elapsed * 1e9 / iterations;
+    r.itemsPerSecond     = c.items * iterations / elapsed;
+    r.allocsPerIteration = double(allocs) / iterations;
+    r.bytesPerIteration  = double(bytes) / iterations;
+    return r;
+}
+
+void writeJson(const std::vector<benchmarkResult>& results,
+               const std::string&                  path) {
+    std::ofstream out(path);
+    out << "{\n  \"context\": {\n"
+        << "    \"executable\": \"extrastl_benchmark\",\n"
+        << "    \"library_build_type\": \"release\"\n  },\n"
+        << "  \"benchmarks\": [\n";
+    for (size_t i = 0; i != results.size(); ++i) {
+        const auto& r = results[i];
+        out << "    {\n"
+            << "      \"name\": \"" << r.name << "\",\n"
+            << "      \"run_name\": \"" << r.name << "\",\n"
+            << "      \"run_type\": \"iteration\",\n"
+            << "      \"iterations\": " << r.iterations << ",\n"
+            << "      \"real_time\": " << r.nsPerIteration << ",\n"
+            << "      \"cpu_time\": " << r.nsPerIteration << ",\n"
+            << "      \"time_unit\": \"ns\",\n"
+            << "      \"items_per_second\": " << r.itemsPerSecond << ",\n"
+            << "      \"allocs_per_iteration\": " << r.allocsPerIteration
+            << ",\n"
+            << "      \"bytes_per_iteration\": " << r.bytesPerIteration << "\n"
+            << "    }" << (i + 1 != results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+// **************************************************************
+// ***************************元素类型*****************************
+// **************************************************************
+
+// 指定大小的 POD 记录，按 key 比较。
+template <size_t Bytes>
+struct record {
+    int  key;
+    char pad[Bytes - sizeof(int)];
+
+    record(int k = 0) : key(k) {}
+    bool operator<(const record& r) const { return key < r.key; }
+    bool operator<=(const record& r) const { return key <= r.key; }
+    bool operator==(const record& r) const { return key == r.key; }
+    bool operator!=(const record& r) const { return key != r.key; }
+};
+
+template <size_t Bytes>
+std::ostream& operator<<(std::ostream& os, const record<Bytes>& r) {
+    return os << r.key;
+}
+
+int keyOf(int x) { return x; }
+template <size_t Bytes>
+int keyOf(const record<Bytes>& r) {
+    return r.key;
+}
+
+template <class T>
+struct typeName;
+template <>
+struct typeName<int> {
+    static std::string get() { return "int"; }
+};
+template <size_t Bytes>
+struct typeName<record<Bytes>> {
+    static std::string get() { return "record" + std::to_string(Bytes); }
+};
+
+std::vector<int> shuffledKeys(size_t n) {
+    std::vector<int> keys(n);
+    for (size_t i = 0; i != n; ++i) keys[i] = static_cast<int>(i);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+    return keys;
+}
+
+std::string suffix(const std::string& impl, const std::string& type,
+                   size_t n) {
+    return "/" + impl + "/" + type + "/" + std::to_string(n);
+}
+
+// 插入、删除中间元素是 O(n^2) 的用例，只在较小的规模上运行。
+const size_t QUADRATIC_LIMIT = 1 << 14;
+
+// **************************************************************
+// ***************************vector******************************
+// **************************************************************
+template <class Vec, class T>
+void vectorCases(const std::string& impl, size_t n) {
+    const std::string s = suffix(impl, typeName<T>::get(), n);
+
+    addCase("vector/push_back" + s, n, [n] {
+        Vec v;
+        for (size_t i = 0; i != n; ++i) v.push_back(T(static_cast<int>(i)));
+        doNotOptimize(v[0]);
+    });
+
+    auto data = std::make_shared<std::unique_ptr<Vec>>();
+    auto fill = [data, n] {
+        data->reset(new Vec);
+        for (int k : shuffledKeys(n)) (*data)->push_back(T(k));
+    };
+    auto release = [data] { data->reset(); };
+
+    if (n <= QUADRATIC_LIMIT) {
+        addCase("vector/insert_middle" + s, n, [n] {
+            Vec v;
+            for (size_t i = 0; i != n; ++i) {
+                v.insert(v.begin() + v.size() / 2, T(static_cast<int>(i)));
+            }
+            doNotOptimize(v[0]);
+        });
+        addCase("vector/erase_middle" + s, n,
+                [data] {
+                    Vec& v = **data;
+                    while (!v.empty()) v.erase(v.begin() + v.size() / 2);
+                },
+                fill, release);
+    }
+
+    addCase("vector/iterate" + s, n,
+            [data] {
+                long sum = 0;
+                for (const auto& x : **data) sum += keyOf(x);
+                doNotOptimize(sum);
+            },
+            [data, fill] {
+                if (!*data) fill();
+            },
+            release);
+
+    addCase("vector/sort" + s, n,
+            [data] { std::sort((*data)->begin(), (*data)->end()); }, fill,
+            release);
+
+    addCase("vector/parallel_sort" + s, n,
+            [data] {
+                extrastl::parallel::sort((*data)->begin(), (*data)->end());
+            },
+            fill, release);
+}
+
+// **************************************************************
+// ***************************list********************************
+// **************************************************************
+// list 与 unrolled_list 共有的用例。
+template <class List, class T>
+void sequenceCases(const std::string& impl, size_t n) {
+    const std::string s = suffix(impl, typeName<T>::get(), n);
+
+    addCase("list/push_back" + s, n, [n] {
+        List l;
+        for (size_t i = 0; i != n; ++i) l.push_back(T(static_cast<int>(i)));
+        doNotOptimize(l.back());
+    });
+
+    addCase("list/push_front" + s, n, [n] {
+        List l;
+        for (size_t i = 0; i != n; ++i) l.push_front(T(static_cast<int>(i)));
+        doNotOptimize(l.front());
+    });
+
+    auto data = std::make_shared<std::unique_ptr<List>>();
+    auto fill = [data, n] {
+        data->reset(new List);
+        for (int k : shuffledKeys(n)) (*data)->push_back(T(k));
+    };
+    auto release = [data] { data->reset(); };
+
+    addCase("list/erase_front" + s, n,
+            [data] {
+                List& l = **data;
+                while (!l.empty()) l.erase(l.begin());
+            },
+            fill, release);
+
+    addCase("list/iterate" + s, n,
+            [data] {
+                long sum = 0;
+                for (const auto& x : **data) sum += keyOf(x);
+                doNotOptimize(sum);
+            },
+            [data, fill] {
+                if (!*data) fill();
+            },
+            release);
+}
+
+template <class List, class T>
+void listCases(const std::string& impl, size_t n) {
+    sequenceCases<List, T>(impl, n);
+
+    auto data = std::make_shared<std::unique_ptr<List>>();
+    auto fill = [data, n] {
+        data->reset(new List);
+        for (int k : shuffledKeys(n)) (*data)->push_back(T(k));
+    };
+    addCase("list/sort" + suffix(impl, typeName<T>::get(), n), n,
+            [data] { (*data)->sort(); }, fill, [data] { data->reset(); });
+}
+
+// std::list 没有对应的接口，只对 extrastl::list 运行。
+template <class T>
+void listParallelSortCase(size_t n) {
+    using List = extrastl::list<T>;
+    auto data  = std::make_shared<std::unique_ptr<List>>();
+    auto fill  = [data, n] {
+        data->reset(new List);
+        for (int k : shuffledKeys(n)) (*data)->push_back(T(k));
+    };
+    addCase("list/parallel_sort" + suffix("extrastl", typeName<T>::get(), n),
+            n, [data] { (*data)->parallel_sort(); }, fill,
+            [data] { data->reset(); });
+}
+
+// **************************************************************
+// ***************************有序集合*****************************
+// **************************************************************
+
+// RBTree、AVLTree 与 std::set 的接口不同，用适配器统一。
+template <class Tree, class T>
+struct binaryTreeSet {
+    Tree tree;
+
+    void insert(const T& key) { tree.insert(key); }
+    bool contains(const T& key) { return tree.iterativeSearch(key) != NULL; }
+    void erase(const T& key) { tree.remove(key); }
+    template <class F>
+    void forEach(F f) {
+        tree.inOrder(f);
+    }
+};
+
+template <class T>
+using rbTreeSet = binaryTreeSet<extrastl::RBTree<T>, T>;
+template <class T>
+using avlTreeSet = binaryTreeSet<extrastl::AVLTree<T>, T>;
+
+// BTree 与 RBTree 接口相同，插入、查找、删除直接对应
+template <class T>
+struct bTreeSet {
+    extrastl::BTree<T> tree;
+
+    void insert(const T& key) { tree.insert(key); }
+    bool contains(const T& key) { return tree.search(key) != nullptr; }
+    void erase(const T& key) { tree.remove(key); }
+    template <class F>
+    void forEach(F f) {
+        tree.inOrder(f);
+    }
+};
+
+// std::set 与 extrastl::set 接口相同，共用一个适配器。
+template <class Set>
+struct stdLikeSet {
+    using T = typename Set::value_type;
+
+    Set set;
+
+    void insert(const T& key) { set.insert(key); }
+    bool contains(const T& key) { return set.find(key) != set.end(); }
+    void erase(const T& key) { set.erase(key); }
+    template <class F>
+    void forEach(F f) {
+        for (const auto& key : set) f(key);
+    }
+};
+
+template <class Set, class T>
+void setCases(const std::string& impl, size_t n) {
+    const std::string s    = suffix(impl, typeName<T>::get(), n);
+    auto              keys = std::make_shared<std::vector<int>>(shuffledKeys(n));
+
+    addCase("set/insert" + s, n, [keys] {
+        Set set;
+        for (int k : *keys) set.insert(T(k));
+        doNotOptimize(set);
+    });
+
+    auto data = std::make_shared<std::unique_ptr<Set>>();
+    auto fill = [data, keys] {
+        data->reset(new Set);
+        for (int k : *keys) (*data)->insert(T(k));
+    };
+    auto fillOnce = [data, fill] {
+        if (!*data) fill();
+    };
+    auto release = [data] { data->reset(); };
+
+    addCase("set/find" + s, n,
+            [data, keys] {
+                size_t found = 0;
+                for (int k : *keys) found += (*data)->contains(T(k));
+                doNotOptimize(found);
+            },
+            fillOnce, release);
+
+    addCase("set/iterate" + s, n,
+            [data] {
+                long sum = 0;
+                (*data)->forEach([&sum](const T& x) { sum += keyOf(x); });
+                doNotOptimize(sum);
+            },
+            fillOnce, release);
+
+    addCase("set/erase" + s, n,
+            [data, keys] {
+                for (int k : *keys) (*data)->erase(T(k));
+            },
+            fill, release);
+}
+
+// 查找与修改混合：每次操作以 readPercent% 的概率查找一个随机键，
+// 否则删除一个已有的键再插回，集合保持不变。
+template <class Set, class T>
+void mixCase(const std::string& impl, size_t n, unsigned readPercent) {
+    // (是否为查找, 键)
+    auto ops = std::make_shared<std::vector<std::pair<bool, int>>>();
+    std::mt19937 rng(7);
+    for (size_t i = 0; i != n; ++i) {
+        ops->emplace_back(rng() % 100 < readPercent, int(rng() % n));
+    }
+
+    auto data = std::make_shared<std::unique_ptr<Set>>();
+    auto fill = [data, n] {
+        if (*data) return;
+        data->reset(new Set);
+        for (int k : shuffledKeys(n)) (*data)->insert(T(k));
+    };
+
+    addCase("set/mix_read" + std::to_string(readPercent)
+                    + suffix(impl, typeName<T>::get(), n),
+            n,
+            [data, ops] {
+                size_t found = 0;
+                for (const auto& op : *ops) {
+                    if (op.first) {
+                        found += (*data)->contains(T(op.second));
+                    } else {
+                        (*data)->erase(T(op.second));
+                        (*data)->insert(T(op.second));
+                    }
+                }
+                doNotOptimize(found);
+            },
+            fill, [data] { data->reset(); });
+}
+
+template <class T>
+void mixCases(size_t n) {
+    for (unsigned readPercent : {95u, 50u}) {
+        mixCase<rbTreeSet<T>, T>("extrastl", n, readPercent);
+        mixCase<avlTreeSet<T>, T>("avl", n, readPercent);
+        mixCase<bTreeSet<T>, T>("btree", n, readPercent);
+        mixCase<stdLikeSet<std::set<T>>, T>("std", n, readPercent);
+    }
+}
+
+// 由有序输入整体建树：RBTree::assign_sorted 与 std::set 带尾部提示的插入。
+template <class T>
+void bulkLoadCases(size_t n) {
+    auto keys = std::make_shared<std::vector<T>>();
+    for (size_t i = 0; i != n; ++i) keys->push_back(T(int(i)));
+
+    addCase("set/bulk_load" + suffix("extrastl", typeName<T>::get(), n), n,
+            [keys] {
+                extrastl::RBTree<T> tree;
+                tree.assign_sorted(keys->begin(), keys->end());
+                doNotOptimize(tree);
+            });
+    addCase("set/bulk_load" + suffix("std", typeName<T>::get(), n), n,
+            [keys] {
+                std::set<T> set;
+                for (const T& k : *keys) set.insert(set.end(), k);
+                doNotOptimize(set);
+            });
+}
+
+// 重启后恢复索引并做一次查找：逐个 insert 重建 RBTree 与 mmap 打开映像文件。
+template <class T>
+void restartCases(size_t n) {
+    auto keys = std::make_shared<std::vector<int>>(shuffledKeys(n));
+    addCase("set/restart" + suffix("extrastl", typeName<T>::get(), n), n,
+            [keys] {
+                extrastl::RBTree<T> tree;
+                for (int k : *keys) tree.insert(T(k));
+                doNotOptimize(tree.iterativeSearch(T(0)));
+            });
+
+    const std::string path = "/tmp/extrastl_benchmark_" + typeName<T>::get()
+                             + "_" + std::to_string(n) + ".img";
+    auto written = std::make_shared<bool>(false);
+    addCase("set/restart" + suffix("image", typeName<T>::get(), n), n,
+            [path] {
+                extrastl::RBTreeImage<T> image(path);
+                doNotOptimize(image.search(T(0)));
+            },
+            [keys, path, written] {
+                if (*written) return;
+                extrastl::RBTree<T> tree;
+                for (int k : *keys) tree.insert(T(k));
+                extrastl::writeImage(tree, path);
+                *written = true;
+            },
+            [path, written] {
+                std::remove(path.c_str());
+                *written = false;
+            });
+}
+
+// 按排名取 p1 ~ p100 分位数：RBTree::select 与 std::set 上的 std::next。
+template <class Set, class T, class Select>
+void percentileCase(const std::string& impl, size_t n, Select select) {
+    auto data = std::make_shared<std::unique_ptr<Set>>();
+    auto fill = [data, n] {
+        if (*data) return;
+        data->reset(new Set);
+        for (int k : shuffledKeys(n)) (*data)->insert(T(k));
+    };
+
+    addCase("set/percentile" + suffix(impl, typeName<T>::get(), n), 100,
+            [data, n, select] {
+                long sum = 0;
+                for (size_t p = 1; p <= 100; ++p) {
+                    sum += keyOf(select(**data, (n - 1) * p / 100));
+                }
+                doNotOptimize(sum);
+            },
+            fill, [data] { data->reset(); });
+}
+
+template <class T>
+void percentileCases(size_t n) {
+    // select 需要维护子树大小的结点
+    using tree = extrastl::RBTree<T, std::less<T>,
+                                  extrastl::RBTNode<T, false, true>>;
+    percentileCase<tree, T>("extrastl", n, [](const tree& t, size_t k) {
+        return t.select(k)->key;
+    });
+    percentileCase<std::set<T>, T>(
+            "std", n, [](const std::set<T>& set, size_t k) {
+                return *std::next(set.begin(), k);
+            });
+}
+
+// 合并两个各含 n 个键、一半重叠的有序集合：
+// RBTree::union_with 与逐个插入的 std::set::insert。
+template <class Set, class T, class Union>
+void unionCase(const std::string& impl, size_t n, Union unite) {
+    auto data = std::make_shared<std::unique_ptr<std::pair<Set, Set>>>();
+    auto fill = [data, n] {
+        data->reset(new std::pair<Set, Set>);
+        for (int k : shuffledKeys(n)) {
+            (*data)->first.insert(T(2 * k));
+            (*data)->second.insert(T(k + int(n)));
+        }
+    };
+
+    addCase("set/union" + suffix(impl, typeName<T>::get(), n), 2 * n,
+            [data, unite] { unite((*data)->first, (*data)->second); }, fill,
+            [data] { data->reset(); });
+}
+
+template <class T>
+void unionCases(size_t n) {
+    using tree = extrastl::RBTree<T>;
+    unionCase<tree, T>("extrastl", n, [](tree& a, tree& b) {
+        a.union_with(b);
+    });
+    unionCase<std::set<T>, T>("std", n, [](std::set<T>& a, std::set<T>& b) {
+        a.insert(b.begin(), b.end());
+    });
+}
+
+// **************************************************************
+// ***************************位图********************************
+// **************************************************************
+
+// bitmap 与 std::bitset 的接口基本一致，只有统计 1 的方法同名。
+template <class Bits, size_t N>
+void bitmapCases(const std::string& impl) {
+    const std::string s    = "/" + impl + "/" + std::to_string(N);
+    auto              bits = std::make_shared<Bits>();
+
+    addCase("bitmap/set" + s, N / 3, [bits] {
+        for (size_t i = 0; i < N; i += 3) bits->set(i);
+    });
+    addCase("bitmap/test" + s, N, [bits] {
+        size_t ones = 0;
+        for (size_t i = 0; i != N; ++i) ones += bits->test(i);
+        doNotOptimize(ones);
+    });
+    addCase("bitmap/count" + s, N, [bits] { doNotOptimize(bits->count()); });
+    addCase("bitmap/flip" + s, N, [bits] { bits->flip(); });
+}
+
+// **************************************************************
+// ***************************注册********************************
+// **************************************************************
+template <class T>
+void registerForType(size_t n) {
+    vectorCases<extrastl::vector<T>, T>("extrastl", n);
+    vectorCases<std::vector<T>, T>("std", n);
+    listCases<extrastl::list<T>, T>("extrastl", n);
+    listCases<std::list<T>, T>("std", n);
+    listParallelSortCase<T>(n);
+    sequenceCases<extrastl::unrolled_list<T>, T>("unrolled", n);
+    setCases<rbTreeSet<T>, T>("extrastl", n);
+    setCases<avlTreeSet<T>, T>("avl", n);
+    setCases<bTreeSet<T>, T>("btree", n);
+    setCases<stdLikeSet<extrastl::set<T>>, T>("extrastl_set", n);
+    setCases<stdLikeSet<std::set<T>>, T>("std", n);
+    bulkLoadCases<T>(n);
+    percentileCases<T>(n);
+    unionCases<T>(n);
+    mixCases<T>(n);
+    restartCases<T>(n);
+}
+
+void registerAll() {
+    for (size_t n : {size_t(1) << 10, size_t(1) << 14, size_t(1) << 18}) {
+        registerForType<int>(n);
+        registerForType<record<64>>(n);
+    }
+    bitmapCases<extrastl::bitmap<1 << 12>, 1 << 12>("extrastl");
+    bitmapCases<std::bitset<1 << 12>, 1 << 12>("std");
+    bitmapCases<extrastl::bitmap<1 << 20>, 1 << 20>("extrastl");
+    bitmapCases<std::bitset<1 << 20>, 1 << 20>("std");
+}
+
+// 解析形如 --name=value 的参数。
+bool parseFlag(const char* arg, const char* name, std::string* value) {
+    const size_t len = std::strlen(name);
+    if (std::strncmp(arg, name, len) != 0 || arg[len] != '=') return false;
+    *value = arg + len + 1;
+    return true;
+}
+}    // namespace
+
+int main(int argc, char** argv) {
+    std::string filter, json, minTimeStr = "0.1";
+    for (int i = 1; i < argc; ++i) {
+        if (!parseFlag(argv[i], "--filter", &filter)
+            && !parseFlag(argv[i], "--json", &json)
+            && !parseFlag(argv[i], "--min_time", &minTimeStr)) {
+            std::cerr << "usage: " << argv[0]
+                      << " [--filter=substr] [--min_time=seconds]"
+                         " [--json=file]\n";
+            return 1;
+        }
+    }
+    const double minTime = std::atof(minTimeStr.c_str());
+
+    registerAll();
+
+    std::vector<benchmarkResult> results;
+    std::printf("%-48s %12s %12s %14s %10s %12s\n", "Benchmark", "Iterations",
+                "ns/iter", "ns/item", "allocs", "bytes");
+    for (const auto& c : registry()) {
+        if (c.name.find(filter) == std::string::npos) continue;
+        auto r = runCase(c, minTime);
+        std::printf("%-48s %12zu %12.0f %14.2f %10.1f %12.0f\n",
+                    r.name.c_str(), r.iterations, r.nsPerIteration,
+                    r.nsPerIteration / c.items, r.allocsPerIteration,
+                    r.bytesPerIteration);
+        results.push_back(r);
+    }
+
+    if (!json.empty()) writeJson(results, json);
+    return 0;
+}
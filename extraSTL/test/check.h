@@ -0,0 +1,17 @@
+#ifndef EXTRASTL_TEST_CHECK_H
+#define EXTRASTL_TEST_CHECK_H
+
+#include <cstdio>
+#include <cstdlib>
+
+// 条件不成立时打印位置并以非零状态退出，不受 NDEBUG 影响
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        if (!(cond)) {                                                         \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__,        \
+                         __LINE__, #cond);                                     \
+            std::exit(1);                                                      \
+        }                                                                      \
+    } while (0)
+
+#endif
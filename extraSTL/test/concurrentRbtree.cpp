@@ -0,0 +1,153 @@
+// concurrent_rbtree 的多线程测试：一个写者不断修改，多个读者同时取快照，
+// 检查快照内容前后一致、clear() 期间旧快照仍然可用、读者离开后旧结点被回收。
+// 建议同时用 -fsanitize=thread 与 -fsanitize=address 各编译运行一次。
+#include "../concurrent_rbtree.h"
+#include "check.h"
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// 记录存活个数的键，析构后 magic 被改写，读到已回收的结点时能发现
+struct tracked {
+    static const long        ALIVE = 0x5a5a5a5a;
+    static std::atomic<long> live;
+
+    long value;
+    long magic;
+
+    tracked(long v) : value(v), magic(ALIVE) { ++live; }
+    tracked(const tracked& other) : value(other.value), magic(ALIVE) {
+        CHECK(other.magic == ALIVE);
+        ++live;
+    }
+    ~tracked() {
+        magic = 0;
+        --live;
+    }
+
+    bool operator<(const tracked& other) const { return value < other.value; }
+};
+const long        tracked::ALIVE;
+std::atomic<long> tracked::live(0);
+
+using tree = extrastl::concurrent_rbtree<tracked>;
+
+const long WINDOW = 64;
+
+// 写者维护的不变式：任何版本中的键都是连续的一段 [lo, lo + n)，
+// 插入之后、删除之前 n 最多为 WINDOW + 1
+void checkSnapshot(const tree::snapshot& snap) {
+    const size_t n = snap.size();
+    CHECK(n <= size_t(WINDOW) + 1);
+    std::vector<long> keys;
+    snap.for_each([&keys](const tracked& k) {
+        CHECK(k.magic == tracked::ALIVE);
+        keys.push_back(k.value);
+    });
+    CHECK(keys.size() == n);
+    for (size_t i = 0; i < n; ++i) {
+        CHECK(keys[i] == keys[0] + long(i));
+        CHECK(snap.select(i)->value == keys[i]);
+        CHECK(snap.rank(tracked(keys[i])) == i);
+        CHECK(snap.contains(tracked(keys[i])));
+    }
+    if (n != 0) {
+        CHECK(!snap.contains(tracked(keys[0] - 1)));
+        CHECK(!snap.contains(tracked(keys[n - 1] + 1)));
+        long sum = 0;
+        snap.range(tracked(keys[0]), tracked(keys[0] + 4),
+                   [&sum](const tracked& k) { sum += k.value; });
+        const long m = n < 4 ? long(n) : 4;
+        CHECK(sum == m * keys[0] + m * (m - 1) / 2);
+    }
+
+    // 写者在此期间继续修改，快照的内容不变
+    std::this_thread::yield();
+    size_t i = 0;
+    snap.for_each([&](const tracked& k) {
+        CHECK(k.magic == tracked::ALIVE);
+        CHECK(i < n && k.value == keys[i]);
+        ++i;
+    });
+    CHECK(i == n);
+}
+
+// 一个写者按滑动窗口插入、删除，不时 clear()；多个读者不断取快照检查
+void testReadersDuringWrites() {
+    tree              t;
+    std::atomic<bool> done(false);
+    std::atomic<long> snapshots(0);
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&] {
+            while (!done.load()) {
+                checkSnapshot(t.take_snapshot());
+                ++snapshots;
+            }
+        });
+    }
+
+    long lo = 0, hi = 0;
+    for (int i = 0; i < 100000; ++i) {
+        if (i % 5000 == 4999) {
+            t.clear();
+            lo = hi;
+            continue;
+        }
+        CHECK(t.insert(tracked(hi++)));
+        CHECK(!t.insert(tracked(hi - 1)));
+        if (hi - lo > WINDOW) CHECK(t.erase(tracked(lo++)));
+    }
+    done.store(true);
+    for (auto& th : readers) th.join();
+    CHECK(snapshots.load() > 0);
+
+    // 没有读者之后再写一次，之前替换下来的结点全部回收
+    CHECK(t.insert(tracked(hi)));
+    CHECK(t.erase(tracked(hi)));
+    CHECK(size_t(tracked::live.load()) == t.size());
+}
+
+// 持有快照期间写者 clear() 并重新插入，快照看到的仍是旧版本，
+// 旧结点在快照释放后的下一次写操作中回收
+void testSnapshotOutlivesClear() {
+    tree t;
+    for (long k = 0; k < 1000; ++k) t.insert(tracked(k));
+
+    auto held = t.take_snapshot();
+    std::thread writer([&t] {
+        for (int round = 0; round < 20; ++round) {
+            t.clear();
+            for (long k = 0; k < 1000; ++k) t.insert(tracked(k * 2 + 1));
+        }
+    });
+    long expected = 0;
+    for (int round = 0; round < 50; ++round) {
+        expected = 0;
+        held.for_each([&expected](const tracked& k) {
+            CHECK(k.magic == tracked::ALIVE);
+            CHECK(k.value == expected++);
+        });
+        CHECK(expected == 1000);
+    }
+    writer.join();
+    CHECK(size_t(tracked::live.load()) > t.size());
+
+    held.release();
+    t.insert(tracked(-1));
+    CHECK(size_t(tracked::live.load()) == t.size());
+}
+}    // namespace
+
+int main() {
+    testReadersDuringWrites();
+    testSnapshotOutlivesClear();
+    CHECK(tracked::live.load() == 0);
+    std::cout << "concurrent_rbtree ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,221 @@
+// intrusive_list 与 std::list 的对照测试：链接、删除、拼接、合并、排序与
+// 移动只修改钩子，元素地址不变；同一元素可以通过两个钩子同时位于两个链表中。
+#include "../intrusive_list.h"
+#include "check.h"
+
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct item {
+    int                           key;
+    int                           seq;
+    extrastl::intrusive_list_hook hook;
+    extrastl::intrusive_list_hook other;
+
+    bool operator<(const item& x) const { return key < x.key; }
+};
+
+using itemList  = extrastl::intrusive_list<item, &item::hook>;
+using otherList = extrastl::intrusive_list<item, &item::other>;
+
+template <class List>
+void checkSame(const List& l, const std::list<const item*>& ref) {
+    CHECK(l.size() == ref.size() && l.empty() == ref.empty());
+    auto it = ref.begin();
+    for (const item& x : l) {
+        CHECK(it != ref.end() && &x == *it);
+        ++it;
+    }
+    CHECK(it == ref.end());
+    // 反向遍历
+    auto rit = ref.rbegin();
+    for (auto i = l.end(); i != l.begin();) {
+        --i;
+        CHECK(&*i == *rit);
+        ++rit;
+    }
+}
+
+void testRandom(std::mt19937& rng) {
+    std::vector<item> items(200);
+    for (int i = 0; i < 200; ++i) items[i].key = i;
+    {
+        itemList               l, m;
+        std::list<const item*> rl, rm;
+        for (int step = 0; step < 20000; ++step) {
+            item& x = items[rng() % items.size()];
+            switch (rng() % 5) {
+            case 0:
+                if (!x.hook.is_linked()) {
+                    l.push_back(x);
+                    rl.push_back(&x);
+                }
+                break;
+            case 1:
+                if (!x.hook.is_linked()) {
+                    m.push_front(x);
+                    rm.push_front(&x);
+                }
+                break;
+            case 2:
+                // 按元素删除，不需要先找到迭代器
+                if (std::find(rl.begin(), rl.end(), &x) != rl.end()) {
+                    l.erase(x);
+                    rl.remove(&x);
+                } else if (x.hook.is_linked()) {
+                    m.erase(x);
+                    rm.remove(&x);
+                }
+                break;
+            case 3:
+                // 把 m 的一段拼接到 l 中
+                if (!rm.empty()) {
+                    const size_t a = rng() % rm.size();
+                    const size_t b = a + rng() % (rm.size() - a + 1);
+                    const size_t p = rl.empty() ? 0 : rng() % rl.size();
+                    auto first = std::next(m.begin(), a);
+                    auto last  = std::next(m.begin(), b);
+                    l.splice(std::next(l.begin(), p), m, first, last);
+                    rl.splice(std::next(rl.begin(), p), rm,
+                              std::next(rm.begin(), a),
+                              std::next(rm.begin(), b));
+                }
+                break;
+            default:
+                if (!rl.empty()) {
+                    const size_t a = rng() % rl.size();
+                    auto         i = l.erase(std::next(l.begin(), a));
+                    auto         r = rl.erase(std::next(rl.begin(), a));
+                    CHECK(r == rl.end() ? i == l.end() : &*i == *r);
+                }
+                break;
+            }
+            if (step % 1000 == 0) {
+                checkSame(l, rl);
+                checkSame(m, rm);
+            }
+        }
+        checkSame(l, rl);
+        checkSame(m, rm);
+        l.splice(l.end(), m);
+        rl.splice(rl.end(), rm);
+        checkSame(l, rl);
+        checkSame(m, rm);
+    }
+    // 链表析构时解除全部链接
+    for (const item& x : items) CHECK(!x.hook.is_linked());
+}
+
+// 等价元素保持原有的相对顺序
+void testSortMerge(std::mt19937& rng) {
+    for (size_t n : {0, 1, 2, 3, 100, 5000}) {
+        std::vector<item> items(n);
+        itemList          l;
+        for (size_t i = 0; i < n; ++i) {
+            items[i].key = int(rng() % 50);
+            items[i].seq = int(i);
+            l.push_back(items[i]);
+        }
+        l.sort();
+        CHECK(l.size() == n);
+        const item* prev = NULL;
+        for (const item& x : l) {
+            CHECK(prev == NULL || prev->key < x.key
+                  || (prev->key == x.key && prev->seq < x.seq));
+            prev = &x;
+        }
+
+        // 按 key 降序排序
+        l.sort([](const item& a, const item& b) { return b.key < a.key; });
+        prev = NULL;
+        for (const item& x : l) {
+            CHECK(prev == NULL || prev->key >= x.key);
+            prev = &x;
+        }
+        l.clear();
+
+        // 两个有序链表合并，相等时 *this 中的元素在前
+        itemList a, b;
+        for (size_t i = 0; i < n; ++i) {
+            (rng() % 2 == 0 ? a : b).push_back(items[i]);
+        }
+        a.sort();
+        b.sort();
+        const size_t na = a.size();
+        a.merge(b);
+        CHECK(a.size() == n && b.empty() && na <= n);
+        prev = NULL;
+        for (const item& x : a) {
+            CHECK(prev == NULL || !(x < *prev));
+            prev = &x;
+        }
+        a.clear();
+    }
+}
+
+// 移动与交换只转移链接，同一元素通过另一个钩子位于另一个链表中
+void testMoveSwap() {
+    std::vector<item> items(10);
+    for (int i = 0; i < 10; ++i) items[i].key = i;
+    {
+        std::list<const item*> ra, rb, rall;
+        itemList               a;
+        otherList              all;
+        for (item& x : items) {
+            all.push_back(x);
+            rall.push_back(&x);
+        }
+        for (int i = 0; i < 6; ++i) {
+            a.push_back(items[i]);
+            ra.push_back(&items[i]);
+        }
+
+        itemList b(std::move(a));
+        checkSame(a, {});
+        checkSame(b, ra);
+        a = std::move(b);
+        checkSame(a, ra);
+        checkSame(b, {});
+
+        for (int i = 6; i < 10; ++i) {
+            b.push_back(items[i]);
+            rb.push_back(&items[i]);
+        }
+        a.swap(b);
+        checkSame(a, rb);
+        checkSame(b, ra);
+
+        // 移动赋值先解除自身原有元素的链接
+        a = std::move(b);
+        checkSame(a, ra);
+        checkSame(b, {});
+        for (int i = 6; i < 10; ++i) CHECK(!items[i].hook.is_linked());
+
+        // 一个空链表与非空链表交换
+        b.swap(a);
+        checkSame(a, {});
+        checkSame(b, ra);
+        checkSame(all, rall);
+        CHECK(&*all.iterator_to(items[3]) == &items[3]);
+    }
+    for (const item& x : items) {
+        CHECK(!x.hook.is_linked() && !x.other.is_linked());
+    }
+}
+}    // namespace
+
+int main() {
+    std::mt19937 rng(13);
+    testRandom(rng);
+    testSortMerge(rng);
+    testMoveSwap();
+    std::cout << "intrusive_list ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,95 @@
+// list::parallel_sort 与 list::sort、std::stable_sort 的结果一致：稳定，
+// 只重新链接节点，排序前取得的迭代器仍指向原来的元素。可平凡复制与
+// 不可平凡复制的元素分别走缓冲区排序与分段归并两条路径；单核机器上
+// 元素再多也直接调用 sort。
+#include "../list.h"
+#include "../algorithm.h"
+#include "check.h"
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const size_t BIG = extrastl::parallel::SERIAL_THRESHOLD * 3 + 3;
+
+// 可平凡复制的元素，seq 记录插入顺序
+struct item {
+    int key;
+    int seq;
+
+    bool operator<(const item& x) const { return key < x.key; }
+};
+
+// 不可平凡复制的元素
+struct named {
+    std::string key;
+    int         seq;
+
+    bool operator<(const named& x) const { return key < x.key; }
+};
+
+template <class T>
+bool sameElement(const T& a, const T& b) {
+    return a.key == b.key && a.seq == b.seq;
+}
+
+template <class T, class Compare>
+void checkSort(extrastl::list<T>& l, Compare comp) {
+    std::vector<T>        ref(l.begin(), l.end());
+    std::vector<const T*> addresses;
+    for (auto& x : l) addresses.push_back(&x);
+    std::stable_sort(ref.begin(), ref.end(), comp);
+
+    extrastl::list<T> copy(l);
+    copy.sort(comp);
+    l.parallel_sort(comp);
+
+    CHECK(l.size() == ref.size());
+    CHECK(std::equal(l.begin(), l.end(), ref.begin(), ref.end(),
+                     sameElement<T>));
+    CHECK(std::equal(l.begin(), l.end(), copy.begin(), copy.end(),
+                     sameElement<T>));
+    // 节点没有被替换：排序前的地址集合与排序后相同，元素也没有改变
+    std::vector<const T*> after;
+    for (auto& x : l) after.push_back(&x);
+    std::sort(addresses.begin(), addresses.end());
+    std::sort(after.begin(), after.end());
+    CHECK(addresses == after);
+
+    // 反向遍历与 prev 指针一致
+    auto r = ref.rbegin();
+    for (auto it = l.end(); it != l.begin(); ++r) {
+        --it;
+        CHECK(sameElement(*it, *r));
+    }
+}
+
+template <class T, class MakeKey>
+void testSizes(std::mt19937& rng, MakeKey makeKey) {
+    for (size_t n : {size_t(0), size_t(1), size_t(2), size_t(1000), BIG}) {
+        for (int range : {5, 1 << 30}) {
+            extrastl::list<T> l;
+            for (size_t i = 0; i < n; ++i) {
+                l.push_back(T{makeKey(int(rng() % range)), int(i)});
+            }
+            checkSort(l, std::less<T>());
+            // 再按降序排一次，输入已有序
+            checkSort(l, [](const T& a, const T& b) { return b < a; });
+            CHECK(l.size() == n);
+        }
+    }
+}
+}    // namespace
+
+int main() {
+    std::mt19937 rng(15);
+    testSizes<item>(rng, [](int k) { return k; });
+    testSizes<named>(rng, [](int k) { return std::to_string(k); });
+    std::cout << "list parallel_sort ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,209 @@
+// map、set 与 std::map、std::set 的对照测试
+#include "../map.h"
+#include "check.h"
+
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+static_assert(
+        std::is_nothrow_move_constructible<extrastl::map<int, int>>::value,
+        "map move constructor must be noexcept");
+static_assert(std::is_nothrow_move_constructible<extrastl::set<int>>::value,
+              "set move constructor must be noexcept");
+
+namespace {
+
+int keyOf(int k) { return k; }
+template <class V>
+int keyOf(const std::pair<const int, V>& p) {
+    return p.first;
+}
+
+// 逐个比较元素，从两端分别遍历一次检查双向迭代器，
+// 再抽查 select、rank、index_of 是否一致
+template <class Container, class Reference>
+void checkSame(const Container& c, const Reference& ref) {
+    CHECK(c.size() == ref.size());
+    CHECK(c.empty() == ref.empty());
+    CHECK(std::equal(c.begin(), c.end(), ref.begin(), ref.end()));
+
+    auto it = c.end();
+    for (auto r = ref.rbegin(); r != ref.rend(); ++r) CHECK(*--it == *r);
+    CHECK(it == c.begin());
+
+    for (size_t i = 0; i < c.size(); i += 1 + c.size() / 16) {
+        auto x = c.select(i);
+        CHECK(c.index_of(x) == i);
+        CHECK(c.rank(keyOf(*x)) == i);
+    }
+    CHECK(c.select(c.size()) == c.end());
+}
+
+void testMapRandom() {
+    std::mt19937             rng(17);
+    extrastl::map<int, long> m;
+    std::map<int, long>      ref;
+    for (int i = 0; i < 20000; ++i) {
+        const int k = rng() % 2000;
+        switch (rng() % 6) {
+        case 0: {
+            auto r  = m.insert(std::make_pair(k, long(i)));
+            auto rr = ref.insert(std::make_pair(k, long(i)));
+            CHECK(r.second == rr.second && r.first->second == rr.first->second);
+            break;
+        }
+        case 1: {
+            auto r  = m.try_emplace(k, i);
+            auto rr = ref.emplace(k, i);
+            CHECK(r.second == rr.second && r.first->second == rr.first->second);
+            break;
+        }
+        case 2:
+            m[k] += i;
+            ref[k] += i;
+            break;
+        case 3:
+            CHECK(m.erase(k) == ref.erase(k));
+            break;
+        case 4: {
+            auto lo = m.lower_bound(k);
+            auto rl = ref.lower_bound(k);
+            CHECK((lo == m.end()) == (rl == ref.end()));
+            if (rl != ref.end()) CHECK(lo->first == rl->first);
+            auto hi = m.upper_bound(k);
+            auto rh = ref.upper_bound(k);
+            CHECK((hi == m.end()) == (rh == ref.end()));
+            if (rh != ref.end()) CHECK(hi->first == rh->first);
+            CHECK(m.count(k) == ref.count(k));
+            break;
+        }
+        default: {
+            // 删除一段区间
+            auto first = m.lower_bound(k);
+            auto last  = m.lower_bound(k + 20);
+            m.erase(first, last);
+            ref.erase(ref.lower_bound(k), ref.lower_bound(k + 20));
+            break;
+        }
+        }
+    }
+    checkSame(m, ref);
+}
+
+// 键已存在时 emplace、try_emplace 不构造新元素
+struct counted {
+    static int constructed;
+    int        value;
+
+    counted(int v) : value(v) { ++constructed; }
+    counted(const counted& other) : value(other.value) { ++constructed; }
+};
+int counted::constructed = 0;
+
+void testNoConstructionOnHit() {
+    extrastl::map<int, counted> m;
+    m.try_emplace(1, 10);
+    const int before = counted::constructed;
+    CHECK(!m.try_emplace(1, 20).second);
+    CHECK(!m.emplace(1, 30).second);
+    CHECK(counted::constructed == before);
+    CHECK(m.at(1).value == 10);
+}
+
+// 异构查找：std::less<> 下用 const char* 查找 std::string 键
+void testHeterogeneousLookup() {
+    extrastl::map<std::string, int, std::less<>> m;
+    m["apple"]  = 1;
+    m["banana"] = 2;
+    CHECK(m.find("banana") != m.end() && m.find("banana")->second == 2);
+    CHECK(m.find("cherry") == m.end());
+    CHECK(m.count("apple") == 1);
+    CHECK(m.lower_bound("b")->first == "banana");
+    CHECK(m.rank("b") == 1);
+}
+
+void testSetBulk() {
+    std::mt19937     rng(3);
+    std::vector<int> keys;
+    for (int i = 0; i < 5000; ++i) keys.push_back(rng() % 4000);
+
+    extrastl::set<int> s;
+    s.insert_range(keys.begin(), keys.end());
+    std::set<int> ref(keys.begin(), keys.end());
+    checkSame(s, ref);
+
+    // 与已有元素归并
+    std::vector<int> more;
+    for (int i = 0; i < 3000; ++i) more.push_back(rng() % 8000);
+    s.insert_range(more.begin(), more.end());
+    ref.insert(more.begin(), more.end());
+    checkSame(s, ref);
+
+    // 有序区间线性构造，重复的键只保留一个
+    std::vector<int> sorted(keys.begin(), keys.end());
+    std::sort(sorted.begin(), sorted.end());
+    extrastl::set<int> t(extrastl::sorted_unique, sorted.begin(),
+                         sorted.end());
+    checkSame(t, std::set<int>(keys.begin(), keys.end()));
+}
+
+void testCopyMoveSwap() {
+    extrastl::set<int> a;
+    for (int i = 0; i < 100; ++i) a.insert(i * 3);
+    std::set<int> ref(a.begin(), a.end());
+
+    extrastl::set<int> b(a);
+    checkSame(b, ref);
+    extrastl::set<int> c(std::move(a));
+    checkSame(c, ref);
+    checkSame(a, std::set<int>());
+    a.insert(1);    // 被移走的容器仍可使用
+    checkSame(a, std::set<int>{1});
+
+    a = c;
+    checkSame(a, ref);
+    b.clear();
+    b = std::move(c);
+    checkSame(b, ref);
+    swap(a, b);
+    checkSame(a, ref);
+
+    // 元素较多时移动进 vector，扩容时按 noexcept 移动
+    std::vector<extrastl::set<int>> v;
+    for (int i = 0; i < 64; ++i) v.push_back(b);
+    for (auto& s : v) checkSame(s, ref);
+}
+
+void testSetOperations() {
+    extrastl::set<int> a, b;
+    std::set<int>      ra, rb;
+    for (int i = 0; i < 1000; ++i) {
+        a.insert(i * 2);
+        ra.insert(i * 2);
+        b.insert(i * 3);
+        rb.insert(i * 3);
+    }
+    std::set<int> expected;
+    std::set_union(ra.begin(), ra.end(), rb.begin(), rb.end(),
+                   std::inserter(expected, expected.end()));
+    a.union_with(b);
+    checkSame(a, expected);
+    checkSame(b, std::set<int>());
+}
+}    // namespace
+
+int main() {
+    testMapRandom();
+    testNoConstructionOnHit();
+    testHeterogeneousLookup();
+    testSetBulk();
+    testCopyMoveSwap();
+    testSetOperations();
+    std::cout << "map ok" << std::endl;
+    return 0;
+}
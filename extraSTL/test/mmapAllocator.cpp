@@ -0,0 +1,84 @@
+// vector 配合 mmapAllocator：可平凡复制的元素扩容与 shrink_to_fit 交给
+// reallocate（Linux 上为 mremap）完成，元素内容与顺序保持不变。
+#include "../mmap_allocator.h"
+#include "../vector.h"
+#include "check.h"
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+namespace {
+
+template <class T, bool HugePages = false>
+using mmapVector = extrastl::vector<T, extrastl::mmapAllocator<T, HugePages>>;
+
+bool pageAligned(const void* p) {
+    return reinterpret_cast<uintptr_t>(p) % ::sysconf(_SC_PAGESIZE) == 0;
+}
+
+template <bool HugePages>
+void testGrowth() {
+    mmapVector<uint64_t, HugePages> v;
+    size_t                          reallocations = 0;
+    const uint64_t*                 data          = NULL;
+    // 扩容到数十 MB，每次扩容都经过 reallocate
+    for (uint64_t i = 0; i < (uint64_t(1) << 22); ++i) {
+        v.push_back(i * 3);
+        if (v.data() != data) {
+            CHECK(pageAligned(v.data()));
+            data = v.data();
+            ++reallocations;
+        }
+    }
+    CHECK(reallocations > 1);
+    CHECK(v.size() == (size_t(1) << 22));
+    for (size_t i = 0; i < v.size(); i += 4097) CHECK(v[i] == i * 3);
+    CHECK(v.back() == (v.size() - 1) * 3);
+
+    // 参数引用自身元素，空间已满时扩容也不会读到失效的内存
+    while (v.size() != v.capacity()) v.push_back(1);
+    v.push_back(v[0]);
+    v.emplace(v.begin() + 1, v[2]);
+    CHECK(v[0] == 0 && v[1] == 6 && v[2] == 3 && v.back() == 0);
+
+    // 收缩后内容不变
+    v.erase(v.begin() + 1000, v.end());
+    v.shrink_to_fit();
+    CHECK(v.size() == 1000 && v.capacity() == 1000);
+    CHECK(pageAligned(v.data()));
+    for (size_t i = 0; i < v.size(); ++i) {
+        CHECK(v[i] == (i == 0 ? 0 : (i == 1 ? 6 : (i - 1) * 3)));
+    }
+    v.reserve(1 << 20);
+    CHECK(v.capacity() == (1 << 20) && v.size() == 1000 && v[999] == 998 * 3);
+
+    v.clear();
+    v.shrink_to_fit();
+    CHECK(v.empty() && v.capacity() == 0);
+    v.push_back(42);
+    CHECK(v.size() == 1 && v[0] == 42);
+}
+
+// 不可平凡复制的元素仍然逐个搬迁，只是空间来自 mmap
+void testNonTrivial() {
+    mmapVector<std::string> v;
+    for (int i = 0; i < 10000; ++i) v.push_back(std::to_string(i));
+    v.shrink_to_fit();
+    CHECK(v.size() == 10000 && v.capacity() == 10000);
+    for (int i = 0; i < 10000; ++i) CHECK(v[i] == std::to_string(i));
+
+    mmapVector<std::string> w(std::move(v));
+    CHECK(v.empty() && w.size() == 10000 && w[9999] == "9999");
+}
+}    // namespace
+
+int main() {
+    testGrowth<false>();
+    testGrowth<true>();
+    testNonTrivial();
+    std::cout << "mmapAllocator ok" << std::endl;
+    return 0;
+}
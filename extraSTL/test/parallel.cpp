@@ -0,0 +1,198 @@
+// extrastl::parallel 与对应串行算法的结果对照，包括空区间、单个元素与
+// 超过 SERIAL_THRESHOLD 的区间；多核机器上后者会分块并行执行。
+// detail::forEachChunk 与 detail::mergeSort 另外以指定的块数测试，
+// 与机器的核数无关。
+#include "../algorithm.h"
+#include "check.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+
+namespace par = extrastl::parallel;
+
+const size_t BIG = par::SERIAL_THRESHOLD * 6 + 7;
+
+std::vector<int> randomInts(size_t n, std::mt19937& rng, int range) {
+    std::vector<int> v(n);
+    for (auto& x : v) x = int(rng() % range);
+    return v;
+}
+
+// 按 key 比较，seq 记录原来的位置，用来检查稳定性
+struct item {
+    int    key;
+    size_t seq;
+};
+bool byKey(const item& a, const item& b) { return a.key < b.key; }
+
+std::vector<item> randomItems(size_t n, std::mt19937& rng, int range) {
+    std::vector<item> v(n);
+    for (size_t i = 0; i < n; ++i) v[i] = item{int(rng() % range), i};
+    return v;
+}
+
+bool sameItems(const std::vector<item>& a, const std::vector<item>& b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+                      [](const item& x, const item& y) {
+                          return x.key == y.key && x.seq == y.seq;
+                      });
+}
+
+// 2x2 矩阵乘法满足结合律但不满足交换律，可以检查部分结果的合并顺序
+struct mat {
+    uint64_t a, b, c, d;
+
+    bool operator==(const mat& m) const {
+        return a == m.a && b == m.b && c == m.c && d == m.d;
+    }
+};
+mat mul(const mat& x, const mat& y) {
+    return mat{x.a * y.a + x.b * y.c, x.a * y.b + x.b * y.d,
+               x.c * y.a + x.d * y.c, x.c * y.b + x.d * y.d};
+}
+
+void testSort(std::mt19937& rng) {
+    for (size_t n : {size_t(0), size_t(1), size_t(2), size_t(1000), BIG}) {
+        for (int range : {3, 1 << 30}) {
+            std::vector<int> v   = randomInts(n, rng, range);
+            std::vector<int> ref = v;
+            std::sort(ref.begin(), ref.end());
+            par::sort(v.begin(), v.end());
+            CHECK(v == ref);
+            par::sort(v.begin(), v.end(), std::greater<int>());
+            std::sort(ref.begin(), ref.end(), std::greater<int>());
+            CHECK(v == ref);
+
+            std::vector<item> s    = randomItems(n, rng, range);
+            std::vector<item> sref = s;
+            std::stable_sort(sref.begin(), sref.end(), byKey);
+            par::stable_sort(s.begin(), s.end(), byKey);
+            CHECK(sameItems(s, sref));
+        }
+    }
+}
+
+// 以 1 到 9 块归并排序，覆盖段数为奇数时最后一段轮空的情形
+void testMergeSortChunks(std::mt19937& rng) {
+    for (size_t n : {0, 1, 5, 8, 1000}) {
+        for (unsigned k = 1; k <= 9; ++k) {
+            std::vector<item> s    = randomItems(n, rng, 7);
+            std::vector<item> sref = s;
+            std::stable_sort(sref.begin(), sref.end(), byKey);
+            par::detail::mergeSort(
+                    s.begin(), s.end(), byKey,
+                    [](std::vector<item>::iterator b,
+                       std::vector<item>::iterator e) {
+                        std::stable_sort(b, e, byKey);
+                    },
+                    k);
+            CHECK(sameItems(s, sref));
+        }
+    }
+}
+
+void testReduce(std::mt19937& rng) {
+    for (size_t n : {size_t(0), size_t(1), size_t(1000), BIG}) {
+        std::vector<int> v = randomInts(n, rng, 1000);
+        CHECK(par::reduce(v.begin(), v.end(), 5L)
+              == std::accumulate(v.begin(), v.end(), 5L));
+
+        std::vector<mat> m(n);
+        for (auto& x : m) x = mat{rng(), rng(), rng(), rng()};
+        const mat one{1, 0, 0, 1};
+        const mat init{3, 1, 4, 1};
+        CHECK(par::reduce(m.begin(), m.end(), init, mul)
+              == std::accumulate(m.begin(), m.end(), init, mul));
+        CHECK(par::reduce(m.begin(), m.end(), one, mul)
+              == std::accumulate(m.begin(), m.end(), one, mul));
+    }
+}
+
+void testFindCount(std::mt19937& rng) {
+    for (size_t n : {size_t(0), size_t(1), size_t(1000), BIG}) {
+        std::vector<int> v = randomInts(n, rng, 1 << 20);
+        // 不存在、只在开头、只在末尾、多处出现
+        std::vector<int> targets{-1, 1 << 20};
+        if (n != 0) {
+            v.front() = 1 << 21;
+            v.back()  = 1 << 22;
+            for (size_t i = n / 3; i < n; i += n / 5 + 1) v[i] = 1 << 23;
+            targets.push_back(1 << 21);
+            targets.push_back(1 << 22);
+            targets.push_back(1 << 23);
+        }
+        for (int t : targets) {
+            auto eq = [t](int x) { return x == t; };
+            CHECK(par::find_if(v.begin(), v.end(), eq)
+                  == std::find_if(v.begin(), v.end(), eq));
+            CHECK(par::count_if(v.begin(), v.end(), eq)
+                  == std::count_if(v.begin(), v.end(), eq));
+        }
+        auto odd = [](int x) { return x % 2 != 0; };
+        CHECK(par::count_if(v.begin(), v.end(), odd)
+              == std::count_if(v.begin(), v.end(), odd));
+
+        std::vector<int> out(n), ref(n);
+        auto             sq = [](int x) { return x / 2 * 3; };
+        CHECK(par::transform(v.begin(), v.end(), out.begin(), sq)
+              == out.end());
+        std::transform(v.begin(), v.end(), ref.begin(), sq);
+        CHECK(out == ref);
+
+        par::for_each(out.begin(), out.end(), [](int& x) { ++x; });
+        for (size_t i = 0; i < n; ++i) CHECK(out[i] == ref[i] + 1);
+    }
+}
+
+// 每个元素恰好属于一块，某一块抛出的异常在所有块结束后重新抛出
+void testForEachChunk() {
+    for (size_t n : {0, 1, 7, 100000}) {
+        for (unsigned k = 1; k <= 8; ++k) {
+            std::vector<std::atomic<int>> hits(n);
+            for (auto& h : hits) h = 0;
+            std::atomic<unsigned> done(0);
+            par::detail::forEachChunk(n, k, [&](unsigned i, size_t b,
+                                                size_t e) {
+                CHECK(b == n * i / k && e == n * (i + 1) / k);
+                for (size_t j = b; j != e; ++j) ++hits[j];
+                ++done;
+            });
+            CHECK(done == k);
+            for (auto& h : hits) CHECK(h == 1);
+
+            bool thrown = false;
+            done        = 0;
+            try {
+                par::detail::forEachChunk(n, k, [&](unsigned i, size_t,
+                                                    size_t) {
+                    ++done;
+                    if (i == k / 2) throw std::runtime_error("chunk");
+                });
+            } catch (const std::runtime_error&) {
+                thrown = true;
+            }
+            CHECK(thrown && done == k);
+        }
+    }
+}
+}    // namespace
+
+int main() {
+    std::mt19937 rng(9);
+    testSort(rng);
+    testMergeSortChunks(rng);
+    testReduce(rng);
+    testFindCount(rng);
+    testForEachChunk();
+    std::cout << "parallel algorithms ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,141 @@
+// RBTree 的批量构造：assign_sorted 与 insert_range 的结果与逐个插入
+// std::multiset 一致，等价的键保持插入顺序，并检查红黑树的结构。
+#include "../rbTree.h"
+#include "check.h"
+#include "rbTreeCheck.h"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+using rbtest::checkTree;
+
+namespace {
+
+// 只按 key 比较，seq 记录插入顺序，用来检查等价键的先后
+struct item {
+    int key;
+    int seq;
+
+    bool operator==(const item& other) const {
+        return key == other.key && seq == other.seq;
+    }
+};
+
+struct byKey {
+    bool operator()(const item& a, const item& b) const {
+        return a.key < b.key;
+    }
+};
+
+using tree   = extrastl::RBTree<item, byKey>;
+using refSet = std::multiset<item, byKey>;
+
+// n 个随机的键，seq 从 firstSeq 开始编号
+std::vector<item> randomItems(std::mt19937& rng, size_t n, int range,
+                              int firstSeq) {
+    std::vector<item> items(n);
+    for (item& x : items) x = item{int(rng() % range), firstSeq++};
+    return items;
+}
+
+// 只保留每组等价键中的第一个
+refSet uniqueOf(const refSet& ref) {
+    refSet res;
+    for (const item& x : ref)
+        if (res.find(x) == res.end()) res.insert(x);
+    return res;
+}
+
+void testAssignSorted(std::mt19937& rng) {
+    // 各种大小，包括 0 与恰好填满若干层的 2^k - 1
+    for (size_t n : {0, 1, 2, 3, 7, 8, 100, 255, 256, 1000}) {
+        std::vector<item> items = randomItems(rng, n, 50, 0);
+        std::stable_sort(items.begin(), items.end(), byKey());
+        refSet ref(items.begin(), items.end());
+
+        tree t;
+        t.insert(item{-1, -1});    // assign_sorted 替换原有结点
+        t.assign_sorted(items.begin(), items.end());
+        checkTree(t, ref);
+
+        t.assign_sorted(items.begin(), items.end(), true);
+        checkTree(t, uniqueOf(ref));
+    }
+}
+
+void testInsertRange(std::mt19937& rng) {
+    for (int round = 0; round < 100; ++round) {
+        tree   t;
+        refSet ref;
+        for (const item& x : randomItems(rng, rng() % 300, 200, 0)) {
+            t.insert(x);
+            ref.insert(x);
+        }
+
+        // 已有结点与新元素中都有等价的键：已有结点在前，新元素保持原顺序
+        std::vector<item> items = randomItems(rng, rng() % 300, 200, 1000);
+        if (round % 2 == 0) {
+            t.insert_range(items.begin(), items.end());
+            ref.insert(items.begin(), items.end());
+            checkTree(t, ref);
+        } else {
+            t.insert_range(items.begin(), items.end(), true);
+            refSet all = ref;
+            all.insert(items.begin(), items.end());
+            checkTree(t, uniqueOf(all));
+        }
+        // 插入后仍然可以正常插入、删除
+        t.insert(item{50, -1});
+        t.remove(item{50, 0});
+    }
+}
+
+// countdown 减到 0 时复制抛出异常
+struct throwing {
+    static int countdown;
+    int        key;
+
+    explicit throwing(int k) : key(k) {}
+    throwing(const throwing& other) : key(other.key) {
+        if (countdown-- == 0) throw std::runtime_error("copy failed");
+    }
+    bool operator<(const throwing& other) const { return key < other.key; }
+    bool operator==(const throwing& other) const { return key == other.key; }
+};
+int throwing::countdown = -1;
+
+void testInsertRangeStrongGuarantee() {
+    extrastl::RBTree<throwing> t;
+    std::multiset<throwing>    ref;
+    for (int i = 0; i < 50; ++i) {
+        t.insert(throwing(i * 2));
+        ref.insert(throwing(i * 2));
+    }
+    std::vector<throwing> items;
+    for (int i = 0; i < 50; ++i) items.push_back(throwing(i * 3));
+
+    throwing::countdown = 30;
+    bool thrown         = false;
+    try {
+        t.insert_range(items.begin(), items.end());
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    throwing::countdown = -1;
+    CHECK(thrown);
+    checkTree(t, ref);
+}
+}    // namespace
+
+int main() {
+    std::mt19937 rng(18);
+    testAssignSorted(rng);
+    testInsertRange(rng);
+    testInsertRangeStrongGuarantee();
+    std::cout << "RBTree bulk construction ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,65 @@
+#ifndef EXTRASTL_TEST_RBTREE_CHECK_H
+#define EXTRASTL_TEST_RBTREE_CHECK_H
+
+#include "../rbTree.h"
+#include "check.h"
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+namespace rbtest {
+
+using extrastl::BLACK;
+using extrastl::RED;
+
+// 子树大小：Node 维护子树大小时与实际结点个数比较
+template <class Node>
+void checkSize(const Node* x, size_t n, std::true_type) {
+    CHECK(x->size == n);
+}
+template <class Node>
+void checkSize(const Node*, size_t, std::false_type) {}
+
+// 检查以 x 为根的子树：父指针、无连续红结点、各路径黑高相同，
+// 返回结点个数，黑高存入 bh
+template <class Node>
+size_t checkNodes(const Node* x, const Node* parent, int& bh) {
+    if (x == NULL) {
+        bh = 0;
+        return 0;
+    }
+    CHECK(x->getParent() == parent);
+    if (x->getColor() == RED) {
+        CHECK(x->left == NULL || x->left->getColor() == BLACK);
+        CHECK(x->right == NULL || x->right->getColor() == BLACK);
+    }
+    int          lh, rh;
+    const size_t n = checkNodes(x->left, x, lh) + checkNodes(x->right, x, rh)
+                     + 1;
+    CHECK(lh == rh);
+    checkSize(x, n, std::integral_constant<bool, Node::countSize>());
+    bh = lh + (x->getColor() == BLACK ? 1 : 0);
+    return n;
+}
+
+// 检查红黑树的结构，并与 ref（通常是 std::multiset）逐个比较键值
+template <class Tree, class Reference>
+void checkTree(const Tree& tree, const Reference& ref) {
+    using T = typename Reference::value_type;
+
+    const typename Tree::node_type* root = tree.first();
+    while (root != NULL && root->getParent() != NULL) root = root->getParent();
+    CHECK(root == NULL || root->getColor() == BLACK);
+    int bh;
+    CHECK(checkNodes(root, static_cast<decltype(root)>(NULL), bh)
+          == ref.size());
+    CHECK(tree.size() == ref.size());
+
+    std::vector<T> keys;
+    tree.inOrder([&keys](const T& k) { keys.push_back(k); });
+    CHECK(std::equal(keys.begin(), keys.end(), ref.begin()));
+}
+}    // namespace rbtest
+
+#endif
@@ -0,0 +1,205 @@
+// RBTreeImage：RBTree 写成映像后重新映射，查询结果与 std::multiset 一致；
+// 文件头损坏、文件被截断或不存在时打开失败并抛出异常。
+#include "../rbTreeImage.h"
+#include "check.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace {
+
+// 每个进程使用不同的文件名，测试结束时删除
+std::string tempPath(const char* name) {
+    return "/tmp/extrastl-" + std::to_string(::getpid()) + "-" + name;
+}
+
+template <class T, class Compare>
+void checkImage(const extrastl::RBTreeImage<T, Compare>& img,
+                const std::multiset<T, Compare>&         ref,
+                std::mt19937&                            rng) {
+    CHECK(img.size() == ref.size());
+    CHECK(img.empty() == ref.empty());
+    CHECK(std::equal(img.begin(), img.end(), ref.begin(), ref.end()));
+
+    size_t i = 0;
+    for (auto it = ref.begin(); it != ref.end(); ++it, ++i) {
+        CHECK(img.select(i) != NULL && *img.select(i) == *it);
+        CHECK(img.rank(*it) == size_t(std::distance(ref.begin(),
+                                                    ref.lower_bound(*it))));
+    }
+    CHECK(img.select(ref.size()) == NULL);
+
+    // 前驱、后继与首尾
+    if (ref.empty()) {
+        CHECK(img.first() == NULL && img.last() == NULL);
+        return;
+    }
+    CHECK(*img.first() == *ref.begin() && *img.last() == *ref.rbegin());
+    CHECK(img.minimum() == *ref.begin() && img.maximum() == *ref.rbegin());
+    CHECK(img.predecessor(img.first()) == NULL);
+    CHECK(img.successor(img.last()) == NULL);
+
+    // 在最小、最大键附近随机取点做查找与区间查询
+    const T lo = *ref.begin(), hi = *ref.rbegin();
+    for (int round = 0; round < 200; ++round) {
+        const T a = lo - 2 + T(rng() % size_t(hi - lo + 5));
+        const T b = a + T(rng() % 20);
+
+        const T* x = img.search(a);
+        CHECK((x != NULL) == (ref.count(a) != 0));
+        if (x != NULL) CHECK(*x == a && x == img.lowerBound(a));
+
+        auto lb = ref.lower_bound(a);
+        auto ub = ref.upper_bound(a);
+        CHECK(lb == ref.end() ? img.lowerBound(a) == NULL
+                              : *img.lowerBound(a) == *lb);
+        CHECK(ub == ref.end() ? img.upperBound(a) == NULL
+                              : *img.upperBound(a) == *ub);
+
+        std::vector<T> got;
+        img.inOrder(a, b, [&got](const T& k) { got.push_back(k); });
+        CHECK(got == std::vector<T>(lb, ref.lower_bound(b)));
+    }
+}
+
+template <class Node>
+void testRoundTrip(std::mt19937& rng) {
+    using tree = extrastl::RBTree<long, std::less<long>, Node>;
+    const std::string path = tempPath("roundtrip.img");
+    for (size_t n : {0, 1, 2, 4095, 4096, 4097, 20000}) {
+        tree                t;
+        std::multiset<long> ref;
+        for (size_t i = 0; i < n; ++i) {
+            const long k = long(rng() % (n + 1)) - long(n / 2);
+            t.insert(k);
+            ref.insert(k);
+        }
+        extrastl::writeImage(t, path);
+        extrastl::RBTreeImage<long> img(path);
+        checkImage(img, ref, rng);
+    }
+    std::remove(path.c_str());
+    // 写入成功后不留下临时文件
+    CHECK(std::ifstream(path + ".tmp").fail());
+}
+
+// 覆盖映像文件中 offset 开始的字节，或把文件截断为 length 字节
+void patch(const std::string& path, size_t offset, const void* p,
+           size_t bytes) {
+    std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+    f.seekp(offset);
+    f.write(static_cast<const char*>(p), bytes);
+    CHECK(f.good());
+}
+void truncate(const std::string& path, size_t length) {
+    CHECK(::truncate(path.c_str(), off_t(length)) == 0);
+}
+
+template <class T>
+bool rejects(const std::string& path) {
+    try {
+        extrastl::RBTreeImage<T> img(path);
+    } catch (const std::system_error&) {
+        return false;
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+void testCorrupt() {
+    using header           = extrastl::detail::rbTreeImageHeader;
+    const std::string path = tempPath("corrupt.img");
+    auto write = [&path] {
+        extrastl::RBTree<long> t;
+        for (long k = 0; k < 100; ++k) t.insert(k);
+        extrastl::writeImage(t, path);
+        extrastl::RBTreeImage<long> img(path);
+        CHECK(img.size() == 100);
+    };
+
+    write();
+    patch(path, offsetof(header, magic), "RBTIMAGX", 8);
+    CHECK(rejects<long>(path));
+
+    write();
+    const uint32_t version = extrastl::detail::RBTREE_IMAGE_VERSION + 1;
+    patch(path, offsetof(header, version), &version, sizeof(version));
+    CHECK(rejects<long>(path));
+
+    write();
+    const uint32_t byteOrder = 0x04030201;
+    patch(path, offsetof(header, byteOrder), &byteOrder, sizeof(byteOrder));
+    CHECK(rejects<long>(path));
+
+    // 键的类型不符
+    write();
+    CHECK(rejects<int>(path));
+    CHECK(rejects<char>(path));
+
+    // 键值个数与文件长度不符
+    write();
+    const uint64_t count = 101;
+    patch(path, offsetof(header, count), &count, sizeof(count));
+    CHECK(rejects<long>(path));
+    write();
+    const uint64_t huge = ~uint64_t(0) / sizeof(long) + 2;
+    patch(path, offsetof(header, count), &huge, sizeof(huge));
+    CHECK(rejects<long>(path));
+
+    write();
+    truncate(path, sizeof(header) + 99 * sizeof(long) + 3);
+    CHECK(rejects<long>(path));
+    truncate(path, sizeof(header) - 1);
+    CHECK(rejects<long>(path));
+    truncate(path, 0);
+    CHECK(rejects<long>(path));
+
+    std::remove(path.c_str());
+    bool thrown = false;
+    try {
+        extrastl::RBTreeImage<long> img(path);
+    } catch (const std::system_error& e) {
+        thrown = e.code().value() == ENOENT;
+    }
+    CHECK(thrown);
+}
+
+// 无法创建临时文件时抛出 std::system_error
+void testWriteFailure() {
+    extrastl::RBTree<long> t;
+    t.insert(1);
+    bool thrown = false;
+    try {
+        extrastl::writeImage(t, "/nonexistent-dir/extrastl.img");
+    } catch (const std::system_error&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+}    // namespace
+
+int main() {
+    std::mt19937 rng(25);
+    testRoundTrip<extrastl::RBTNode<long>>(rng);
+    testRoundTrip<extrastl::RBTNode<long, true>>(rng);
+    testRoundTrip<extrastl::RBTNode<long, false, true>>(rng);
+    testCorrupt();
+    testWriteFailure();
+    std::cout << "RBTreeImage ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,110 @@
+// RBTree 的顺序统计：随机插入、删除后 select、rank、indexOf 与
+// std::multiset 一致，子树大小与红黑树的结构始终正确。
+#include "../rbTree.h"
+#include "check.h"
+#include "rbTreeCheck.h"
+
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <set>
+
+using rbtest::checkTree;
+
+namespace {
+
+template <bool PackColor>
+using countedTree = extrastl::RBTree<long, std::less<long>,
+                                     extrastl::RBTNode<long, PackColor, true>>;
+
+template <class Tree>
+void checkOrderStatistics(const Tree& t, const std::multiset<long>& ref) {
+    size_t i = 0;
+    for (auto it = ref.begin(); it != ref.end(); ++it, ++i) {
+        const auto* x = t.select(i);
+        CHECK(x != NULL && x->key == *it);
+        CHECK(t.indexOf(x) == i);
+        CHECK(t.rank(*it) == size_t(std::distance(ref.begin(),
+                                                  ref.lower_bound(*it))));
+    }
+    CHECK(t.select(ref.size()) == NULL);
+    // 树中没有的键
+    CHECK(t.rank(-1L) == 0);
+    CHECK(t.rank(1L << 40) == ref.size());
+}
+
+// 经过 insert、remove、link、erase 各条路径后检查
+template <class Tree>
+void testRandom(std::mt19937& rng) {
+    Tree                t;
+    std::multiset<long> ref;
+    for (int i = 0; i < 20000; ++i) {
+        const long k = rng() % 1000;
+        switch (rng() % 4) {
+        case 0:
+            t.insert(k);
+            ref.insert(k);
+            break;
+        case 1: {
+            typename Tree::node_type* parent;
+            bool                      isLeft;
+            if (t.findSlot(k, parent, isLeft) == NULL) {
+                t.link(t.newNode(k), parent, isLeft);
+                ref.insert(k);
+            }
+            break;
+        }
+        case 2:
+            if (ref.count(k) != 0) {
+                t.remove(k);
+                ref.erase(ref.find(k));
+            }
+            break;
+        default:
+            if (auto* x = t.find(k)) {
+                t.erase(x);
+                ref.erase(ref.find(k));
+            }
+            break;
+        }
+        if (i % 1000 == 0) {
+            checkTree(t, ref);
+            checkOrderStatistics(t, ref);
+        }
+    }
+    checkTree(t, ref);
+    checkOrderStatistics(t, ref);
+}
+
+// 顺序统计在 join、split 与批量构造之后仍然正确
+template <class Tree>
+void testAfterRebuild(std::mt19937& rng) {
+    Tree                t;
+    std::multiset<long> ref;
+    std::vector<long>   keys;
+    for (int i = 0; i < 3000; ++i) keys.push_back(rng() % 2000);
+    t.insert_range(keys.begin(), keys.end());
+    ref.insert(keys.begin(), keys.end());
+    checkOrderStatistics(t, ref);
+
+    Tree right;
+    t.split(1000L, right);
+    checkOrderStatistics(t, std::multiset<long>(ref.begin(),
+                                                ref.lower_bound(1000)));
+    checkOrderStatistics(right, std::multiset<long>(ref.lower_bound(1000),
+                                                    ref.end()));
+    t.join(right);
+    checkTree(t, ref);
+    checkOrderStatistics(t, ref);
+}
+}    // namespace
+
+int main() {
+    std::mt19937 rng(19);
+    testRandom<countedTree<false>>(rng);
+    testRandom<countedTree<true>>(rng);
+    testAfterRebuild<countedTree<false>>(rng);
+    testAfterRebuild<countedTree<true>>(rng);
+    std::cout << "RBTree order statistics ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,204 @@
+// RBTree 的 join、split 与集合运算：结果与 std::multiset 比较，
+// 并检查红黑树的结构。用 -fsanitize=address 编译可以发现结点池的误用。
+#include "../rbTree.h"
+#include "check.h"
+#include "rbTreeCheck.h"
+
+#include <iostream>
+#include <random>
+#include <set>
+
+using rbtest::checkTree;
+
+namespace {
+
+using tree        = extrastl::RBTree<long>;
+using countedTree = extrastl::RBTree<long, std::less<long>,
+                                     extrastl::RBTNode<long, false, true>>;
+using keySet      = std::multiset<long>;
+
+template <class Tree>
+void fill(Tree& t, keySet& ref, const std::vector<long>& keys) {
+    for (long k : keys) {
+        t.insert(k);
+        ref.insert(k);
+    }
+}
+
+// 有重复键时 split 把所有与 key 等价的结点都分到右侧
+template <class Tree>
+void testSplitDuplicates() {
+    Tree   left, right;
+    keySet ref;
+    fill(left, ref, {1, 2, 2, 2, 2, 2, 2, 3, 4, 5});
+    left.split(2L, right);
+    checkTree(left, keySet{1});
+    checkTree(right, keySet{2, 2, 2, 2, 2, 2, 3, 4, 5});
+
+    left.join(right);
+    checkTree(left, ref);
+    checkTree(right, keySet());
+}
+
+// 随机插入、删除后按随机的键拆分再连接
+template <class Tree>
+void testJoinSplit(std::mt19937& rng) {
+    for (int round = 0; round < 200; ++round) {
+        Tree   t;
+        keySet ref;
+        for (int i = rng() % 400; i > 0; --i) {
+            const long k = rng() % 100;
+            if (rng() % 4 != 0) {
+                t.insert(k);
+                ref.insert(k);
+            } else if (ref.count(k) != 0) {
+                t.remove(k);
+                ref.erase(ref.find(k));
+            }
+        }
+        checkTree(t, ref);
+
+        const long key = rng() % 110;
+        Tree       right;
+        t.split(key, right);
+        checkTree(t, keySet(ref.begin(), ref.lower_bound(key)));
+        checkTree(right, keySet(ref.lower_bound(key), ref.end()));
+
+        if (rng() % 2 == 0 && right.size() != 0) {
+            // 带中间键连接：取出 right 的最小键作为中间键
+            const long mid = right.first()->key;
+            right.remove(mid);
+            t.join(mid, right);
+        } else {
+            t.join(right);
+        }
+        checkTree(t, ref);
+        checkTree(right, keySet());
+    }
+}
+
+// 两棵树各含随机的、互不重复的键，部分键两棵树都有
+std::vector<long> uniqueKeys(std::mt19937& rng, size_t n, long range) {
+    std::set<long> keys;
+    while (keys.size() < n) keys.insert(rng() % range);
+    std::vector<long> res(keys.begin(), keys.end());
+    std::shuffle(res.begin(), res.end(), rng);
+    return res;
+}
+
+template <class Tree>
+void testSetOperations(std::mt19937& rng, size_t n) {
+    for (int op = 0; op < 3; ++op) {
+        Tree   a, b;
+        keySet ra, rb, expected;
+        fill(a, ra, uniqueKeys(rng, n, long(n) * 3));
+        fill(b, rb, uniqueKeys(rng, n, long(n) * 3));
+        if (op == 0) {
+            std::set_union(ra.begin(), ra.end(), rb.begin(), rb.end(),
+                           std::inserter(expected, expected.end()));
+            a.union_with(b);
+        } else if (op == 1) {
+            std::set_intersection(ra.begin(), ra.end(), rb.begin(), rb.end(),
+                                  std::inserter(expected, expected.end()));
+            a.intersect_with(b);
+        } else {
+            std::set_difference(ra.begin(), ra.end(), rb.begin(), rb.end(),
+                                std::inserter(expected, expected.end()));
+            a.difference_with(b);
+        }
+        checkTree(a, expected);
+        checkTree(b, keySet());
+    }
+}
+
+// split 得到的两半共用结点池，其中一半再与第三棵树做集合运算，
+// 之后各棵树按不同顺序销毁
+template <class Tree>
+void testSplitThenSetOperation(std::mt19937& rng) {
+    for (int round = 0; round < 60; ++round) {
+        Tree   a, c;
+        keySet ra, rc;
+        fill(a, ra, uniqueKeys(rng, 300, 600));
+        fill(c, rc, uniqueKeys(rng, 300, 600));
+
+        Tree       b;
+        const long key = rng() % 600;
+        a.split(key, b);
+        keySet rb(ra.lower_bound(key), ra.end());
+        ra.erase(ra.lower_bound(key), ra.end());
+
+        // 轮流让共用结点池的一半作为参数或作为本树
+        keySet expected;
+        switch (round % 4) {
+        case 0:
+            std::set_union(rc.begin(), rc.end(), ra.begin(), ra.end(),
+                           std::inserter(expected, expected.end()));
+            c.union_with(a);
+            ra.clear();
+            break;
+        case 1:
+            std::set_intersection(rc.begin(), rc.end(), rb.begin(), rb.end(),
+                                  std::inserter(expected, expected.end()));
+            c.intersect_with(b);
+            rb.clear();
+            break;
+        case 2:
+            std::set_difference(rc.begin(), rc.end(), ra.begin(), ra.end(),
+                                std::inserter(expected, expected.end()));
+            c.difference_with(a);
+            ra.clear();
+            break;
+        default:
+            std::set_union(ra.begin(), ra.end(), rc.begin(), rc.end(),
+                           std::inserter(expected, expected.end()));
+            a.union_with(c);
+            ra = expected;
+            expected.clear();
+            rc.clear();
+            break;
+        }
+        if (round % 4 != 3) rc = expected;
+        checkTree(a, ra);
+        checkTree(b, rb);
+        checkTree(c, rc);
+
+        // 先销毁一半，另一半与 c 必须仍然可用
+        if (round % 2 == 0) {
+            a.destroy();
+            ra.clear();
+        } else {
+            b.destroy();
+            rb.clear();
+        }
+        for (long k = 1000; k < 1100; ++k) {
+            a.insert(k);
+            b.insert(k);
+            c.insert(k);
+            ra.insert(k);
+            rb.insert(k);
+            rc.insert(k);
+        }
+        checkTree(a, ra);
+        checkTree(b, rb);
+        checkTree(c, rc);
+    }
+}
+
+template <class Tree>
+void testAll(const char* name) {
+    std::mt19937 rng(20);
+    testSplitDuplicates<Tree>();
+    testJoinSplit<Tree>(rng);
+    testSetOperations<Tree>(rng, 100);
+    // 足够大时集合运算会分出线程
+    testSetOperations<Tree>(rng, 100000);
+    testSplitThenSetOperation<Tree>(rng);
+    std::cout << name << " ok" << std::endl;
+}
+}    // namespace
+
+int main() {
+    testAll<tree>("RBTree");
+    testAll<countedTree>("RBTree with subtree sizes");
+    return 0;
+}
@@ -0,0 +1,257 @@
+// small_vector 与 std::vector 的对照测试：内部缓冲区与堆空间之间的转移、
+// 插入删除、移动与交换，以及元素构造抛出异常时不泄漏元素和空间。
+#include "../small_vector.h"
+#include "check.h"
+
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+const size_t INLINE = 4;
+
+template <class T>
+using smallVec = extrastl::small_vector<T, INLINE>;
+
+template <class T>
+bool isInline(const smallVec<T>& v) {
+    const char* p = reinterpret_cast<const char*>(v.begin());
+    const char* o = reinterpret_cast<const char*>(&v);
+    return p >= o && p < o + sizeof(v);
+}
+
+template <class T>
+void checkSame(const smallVec<T>& v, const std::vector<T>& ref) {
+    CHECK(v.size() == ref.size() && v.empty() == ref.empty());
+    CHECK(v.capacity() >= v.size() && v.capacity() >= INLINE);
+    CHECK(std::equal(v.begin(), v.end(), ref.begin(), ref.end()));
+    // 元素不超过 N 个时不会离开内部缓冲区，除非曾经扩容到堆上
+    if (v.capacity() == INLINE) CHECK(isInline(v));
+}
+
+void testInlineToHeap() {
+    smallVec<int> v;
+    CHECK(isInline(v) && v.capacity() == INLINE);
+    for (int i = 0; i < int(INLINE); ++i) v.push_back(i);
+    CHECK(isInline(v));
+    v.push_back(4);
+    CHECK(!isInline(v) && v.capacity() > INLINE);
+    checkSame(v, {0, 1, 2, 3, 4});
+
+    // 元素减少到 N 个以内后 shrink_to_fit 搬回内部缓冲区
+    v.pop_back();
+    v.pop_back();
+    v.shrink_to_fit();
+    CHECK(isInline(v));
+    checkSame(v, {0, 1, 2});
+    v.reserve(100);
+    CHECK(!isInline(v) && v.capacity() == 100);
+    v.resize(10, 9);
+    v.shrink_to_fit();
+    CHECK(!isInline(v) && v.capacity() == 10);
+    checkSame(v, {0, 1, 2, 9, 9, 9, 9, 9, 9, 9});
+}
+
+void testRandom(std::mt19937& rng) {
+    for (int round = 0; round < 200; ++round) {
+        smallVec<std::string>    v;
+        std::vector<std::string> ref;
+        for (int i = 0; i < 50; ++i) {
+            const std::string s = std::to_string(rng() % 100)
+                                  + std::string(rng() % 2 * 30, 'x');
+            const size_t      pos = ref.empty() ? 0 : rng() % ref.size();
+            switch (rng() % 6) {
+            case 0:
+                v.push_back(s);
+                ref.push_back(s);
+                break;
+            case 1:
+                v.insert(v.begin() + pos, s);
+                ref.insert(ref.begin() + pos, s);
+                break;
+            case 2:
+                // 插入自身的元素
+                if (!ref.empty()) {
+                    v.insert(v.begin() + pos, 3, v[0]);
+                    ref.insert(ref.begin() + pos, 3, ref[0]);
+                }
+                break;
+            case 3:
+                if (!ref.empty()) {
+                    v.erase(v.begin() + pos);
+                    ref.erase(ref.begin() + pos);
+                }
+                break;
+            case 4: {
+                const size_t n = rng() % 8;
+                v.resize(n);
+                ref.resize(n);
+                break;
+            }
+            default:
+                v.emplace(v.begin() + pos, 2, 'y');
+                ref.emplace(ref.begin() + pos, 2, 'y');
+                break;
+            }
+            checkSame(v, ref);
+        }
+        v.erase(v.begin(), v.begin() + ref.size() / 2);
+        ref.erase(ref.begin(), ref.begin() + ref.size() / 2);
+        checkSame(v, ref);
+    }
+}
+
+// 移动、复制与交换在内部缓冲区与堆空间的四种组合下都正确
+void testMoveSwap() {
+    for (size_t n : {0, 2, 4, 5, 20}) {
+        for (size_t m : {0, 3, 4, 9}) {
+            std::vector<std::string> ra, rb;
+            for (size_t i = 0; i < n; ++i) ra.push_back(std::to_string(i));
+            for (size_t i = 0; i < m; ++i) {
+                rb.push_back("b" + std::to_string(i));
+            }
+            smallVec<std::string> a(ra.begin(), ra.end());
+            smallVec<std::string> b(rb.begin(), rb.end());
+
+            a.swap(b);
+            checkSame(a, rb);
+            checkSame(b, ra);
+            a.swap(b);
+
+            // 在堆上的元素直接接管，不搬迁
+            const std::string* p = a.begin();
+            smallVec<std::string> c(std::move(a));
+            checkSame(c, ra);
+            checkSame(a, {});
+            if (n > INLINE) CHECK(c.begin() == p);
+
+            b = std::move(c);
+            checkSame(b, ra);
+            checkSame(c, {});
+            c = b;
+            checkSame(c, ra);
+            checkSame(b, ra);
+        }
+    }
+}
+
+// 第 limit 次复制时抛出异常；移动构造可能抛异常，搬迁时退化为复制
+struct throwing {
+    static int copies;
+    static int limit;
+    static int live;
+
+    int value;
+
+    explicit throwing(int v) : value(v) {
+        if (v < 0) throw std::runtime_error("construct");
+        ++live;
+    }
+    throwing(const throwing& other) : value(other.value) {
+        if (++copies == limit) throw std::runtime_error("copy");
+        ++live;
+    }
+    throwing& operator=(const throwing&) = default;
+    ~throwing() { --live; }
+
+    bool operator==(const throwing& other) const {
+        return value == other.value;
+    }
+};
+int throwing::copies = 0;
+int throwing::limit  = 0;
+int throwing::live   = 0;
+
+template <class F>
+bool throws(F f) {
+    try {
+        f();
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+void checkValues(const smallVec<throwing>& v, int n) {
+    CHECK(v.size() == size_t(n));
+    for (int i = 0; i < n; ++i) CHECK(v.begin()[i].value == i);
+}
+
+// 抛出异常后元素与空间保持不变，配合 -fsanitize=address 检查泄漏
+void testThrowing() {
+    {
+        smallVec<throwing> v;
+        for (int i = 0; i < int(INLINE); ++i) v.emplace_back(i);
+
+        // 离开内部缓冲区时构造新元素失败
+        CHECK(throws([&v] { v.emplace_back(-1); }));
+        CHECK(isInline(v) && throwing::live == int(INLINE));
+        checkValues(v, INLINE);
+
+        // 构造新元素后搬迁旧元素失败
+        throwing::copies = 0;
+        throwing::limit  = 2;
+        CHECK(throws([&v] { v.emplace_back(int(INLINE)); }));
+        CHECK(isInline(v) && throwing::live == int(INLINE));
+        checkValues(v, INLINE);
+
+        throwing::limit = 0;
+        for (int i = INLINE; i < 8; ++i) v.emplace_back(i);
+        CHECK(!isInline(v) && v.size() == v.capacity());
+        const throwing* p = v.begin();
+
+        // 堆上扩容、reserve、收缩时搬迁失败
+        throwing::copies = 0;
+        throwing::limit  = 5;
+        CHECK(throws([&v] { v.emplace_back(8); }));
+        CHECK(v.begin() == p && throwing::live == 8);
+        throwing::copies = 0;
+        CHECK(throws([&v] { v.reserve(64); }));
+        CHECK(v.begin() == p && throwing::live == 8);
+        checkValues(v, 8);
+
+        throwing::limit = 0;
+        v.reserve(64);
+        v.resize(3, throwing(0));
+        throwing::copies = 0;
+        throwing::limit  = 2;
+        CHECK(throws([&v] { v.shrink_to_fit(); }));
+        CHECK(!isInline(v) && throwing::live == 3);
+        checkValues(v, 3);
+
+        // 堆上的元素由移动构造直接接管，不复制
+        throwing::copies = 0;
+        smallVec<throwing> w(std::move(v));
+        CHECK(throwing::copies == 0 && v.empty() && throwing::live == 3);
+        v = std::move(w);
+        CHECK(throwing::copies == 0);
+
+        // 内部缓冲区中的元素逐个搬迁，移动构造失败
+        throwing::limit = 0;
+        v.shrink_to_fit();
+        CHECK(isInline(v));
+        checkValues(v, 3);
+        throwing::copies = 0;
+        throwing::limit  = 3;
+        CHECK(throws([&v] { smallVec<throwing> w(std::move(v)); }));
+        CHECK(throwing::live == 3);
+        checkValues(v, 3);
+        throwing::limit = 0;
+    }
+    CHECK(throwing::live == 0);
+}
+}    // namespace
+
+int main() {
+    std::mt19937 rng(4);
+    testInlineToHeap();
+    testRandom(rng);
+    testMoveSwap();
+    testThrowing();
+    std::cout << "small_vector ok" << std::endl;
+    return 0;
+}
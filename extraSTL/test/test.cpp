@@ -1,6 +1,7 @@
 #include "../vector.h"
 #include "../bitmap.h"
 #include "../list.h"
+#include "../arena.h"
 #include <iostream>
 using namespace std;
 
@@ -8,10 +9,17 @@ int main() {
     extrastl::vector<int>  vec;
     extrastl::bitmap<1000> bm;
     extrastl::list<int>    l;
+
     l.push_back(11);
     l.push_back(11);
     l.push_back(11);
     cout << l.size() << l.back() << endl;
 
+    extrastl::arena                                      a;
+    extrastl::vector<int, extrastl::arenaAllocator<int>> av{
+            extrastl::arenaAllocator<int>(a)};
+    for (int i = 0; i != 100; ++i) av.push_back(i);
+    cout << av.size() << av.back() << endl;
+
     return 0;
 }
\ No newline at end of file
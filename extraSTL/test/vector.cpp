@@ -0,0 +1,226 @@
+// vector 的扩容、移动与赋值：嵌套的 vector 扩容时移动而非复制内层元素，
+// 元素的复制构造抛出异常时扩容的 vector 保持原样，赋值的 vector 变为空。
+// resize_for_overwrite 与 default_init 只做默认初始化。
+#include "../vector.h"
+#include "../arena.h"
+#include "check.h"
+
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace {
+
+static_assert(std::is_nothrow_move_constructible<
+                      extrastl::vector<int>>::value,
+              "vector must be nothrow move constructible");
+static_assert(std::is_nothrow_move_assignable<extrastl::vector<int>>::value,
+              "vector must be nothrow move assignable");
+static_assert(std::is_nothrow_move_assignable<extrastl::vector<
+                      int, extrastl::arenaAllocator<int>>>::value,
+              "propagating allocators must allow nothrow move assignment");
+
+// 外层扩容时内层 vector 被移动，元素地址不变
+void testNestedGrowth() {
+    extrastl::vector<extrastl::vector<int>> vv;
+    extrastl::vector<const int*>            inner;
+    for (int i = 0; i < 1000; ++i) {
+        extrastl::vector<int> v;
+        for (int j = 0; j <= i % 7; ++j) v.push_back(i + j);
+        inner.push_back(&v[0]);
+        vv.push_back(std::move(v));
+    }
+    CHECK(vv.size() == 1000);
+    for (int i = 0; i < 1000; ++i) {
+        CHECK(&vv[i][0] == inner[i]);
+        CHECK(vv[i].size() == size_t(i % 7 + 1) && vv[i][0] == i);
+    }
+
+    // 移动赋值接管内存
+    extrastl::vector<int> a(100, 7), b;
+    const int*            p = a.data();
+    b                       = std::move(a);
+    CHECK(b.data() == p && b.size() == 100 && a.empty());
+}
+
+// 复制第 limit 次时抛出异常，没有不抛异常的移动构造
+struct throwing {
+    static int copies;
+    static int limit;
+    static int live;
+
+    int value;
+
+    explicit throwing(int v) : value(v) { ++live; }
+    throwing(const throwing& other) : value(other.value) {
+        if (++copies == limit) throw std::runtime_error("copy");
+        ++live;
+    }
+    throwing& operator=(const throwing&) = default;
+    ~throwing() { --live; }
+};
+int throwing::copies = 0;
+int throwing::limit  = 0;
+int throwing::live   = 0;
+
+void testThrowingGrowth() {
+    {
+        extrastl::vector<throwing> v;
+        for (int i = 0; i < 8; ++i) v.emplace_back(i);
+        CHECK(v.size() == v.capacity());
+        const throwing* p = v.data();
+
+        // 扩容搬迁途中抛出异常，旧元素与旧空间保持不变
+        throwing::copies = 0;
+        throwing::limit  = 5;
+        bool thrown      = false;
+        try {
+            v.emplace_back(8);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        CHECK(thrown);
+        CHECK(v.data() == p && v.size() == 8);
+        for (int i = 0; i < 8; ++i) CHECK(v[i].value == i);
+        CHECK(throwing::live == 8);
+
+        throwing::limit = 0;
+        v.emplace_back(8);
+        CHECK(v.size() == 9 && v[8].value == 8 && throwing::live == 9);
+    }
+    CHECK(throwing::live == 0);
+}
+
+// 有状态、不随赋值传播的分配器，id 不同的实例互不相等
+template <class T>
+struct taggedAllocator {
+    using value_type = T;
+
+    int id;
+
+    explicit taggedAllocator(int i) : id(i) {}
+    template <class U>
+    taggedAllocator(const taggedAllocator<U>& other) : id(other.id) {}
+
+    T*   allocate(size_t n) { return std::allocator<T>().allocate(n); }
+    void deallocate(T* p, size_t n) { std::allocator<T>().deallocate(p, n); }
+
+    bool operator==(const taggedAllocator& other) const {
+        return id == other.id;
+    }
+    bool operator!=(const taggedAllocator& other) const {
+        return id != other.id;
+    }
+};
+
+// 赋值途中复制抛出异常后 vector 为空，析构时不会再次释放旧空间
+void testThrowingAssign() {
+    using tagged = extrastl::vector<throwing, taggedAllocator<throwing>>;
+    {
+        extrastl::vector<throwing> a, b;
+        for (int i = 0; i < 8; ++i) a.emplace_back(i);
+        for (int i = 0; i < 3; ++i) b.emplace_back(i);
+
+        throwing::copies = 0;
+        throwing::limit  = 4;
+        bool thrown      = false;
+        try {
+            b = a;
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        CHECK(thrown && b.empty() && throwing::live == 8);
+
+        throwing::limit = 0;
+        b               = a;
+        CHECK(b.size() == 8 && b[7].value == 7 && throwing::live == 16);
+
+        // 分配器不相等时逐个移动（这里退化为复制）元素
+        tagged c{taggedAllocator<throwing>(1)};
+        tagged d{taggedAllocator<throwing>(2)};
+        for (int i = 0; i < 8; ++i) c.emplace_back(i);
+        d.emplace_back(0);
+        throwing::copies = 0;
+        throwing::limit  = 6;
+        thrown           = false;
+        try {
+            d = std::move(c);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        CHECK(thrown && d.empty() && d.get_allocator().id == 2);
+        CHECK(throwing::live == 24);
+    }
+    CHECK(throwing::live == 0);
+}
+
+// 新分配的空间填满 FILL，用来判断元素有没有被清零
+const unsigned char FILL = 0xab;
+
+template <class T>
+struct fillAllocator {
+    using value_type = T;
+
+    fillAllocator() = default;
+    template <class U>
+    fillAllocator(const fillAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        T* p = std::allocator<T>().allocate(n);
+        std::memset(static_cast<void*>(p), FILL, n * sizeof(T));
+        return p;
+    }
+    void deallocate(T* p, size_t n) { std::allocator<T>().deallocate(p, n); }
+
+    bool operator==(const fillAllocator&) const { return true; }
+    bool operator!=(const fillAllocator&) const { return false; }
+};
+
+bool untouched(const unsigned* first, const unsigned* last) {
+    for (; first != last; ++first) {
+        if (*first != 0xababababu) return false;
+    }
+    return true;
+}
+
+void testResizeForOverwrite() {
+    using buffer = extrastl::vector<unsigned, fillAllocator<unsigned>>;
+    buffer v(4, 7u);
+    v.resize_for_overwrite(100);
+    CHECK(v.size() == 100 && v.capacity() >= 100);
+    for (int i = 0; i < 4; ++i) CHECK(v[i] == 7);
+    CHECK(untouched(v.begin() + 4, v.end()));
+
+    // 缩小时与 resize 相同；容量足够时不重新分配
+    v.resize_for_overwrite(2);
+    CHECK(v.size() == 2 && v[1] == 7);
+    const unsigned* p = v.data();
+    v.resize_for_overwrite(50);
+    CHECK(v.data() == p && v.size() == 50);
+    v.resize(60);
+    CHECK(v[59] == 0);
+
+    buffer w(1000, extrastl::default_init);
+    CHECK(w.size() == 1000 && untouched(w.begin(), w.end()));
+
+    // 非平凡的类型仍然调用默认构造函数
+    extrastl::vector<std::string> s(3, std::string("abc"));
+    s.resize_for_overwrite(10);
+    CHECK(s.size() == 10 && s[2] == "abc" && s[9].empty());
+    extrastl::vector<std::string> t(5, extrastl::default_init);
+    CHECK(t.size() == 5 && t[4].empty());
+}
+}    // namespace
+
+int main() {
+    testNestedGrowth();
+    testThrowingGrowth();
+    testThrowingAssign();
+    testResizeForOverwrite();
+    std::cout << "vector ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,440 @@
+#ifndef EXTRASTL_UNROLLED_LIST_H
+#define EXTRASTL_UNROLLED_LIST_H
+
+#include "pool.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace extrastl {
+namespace detail {
+
+// 展开链表节点的链接部分，哨兵节点只有这一部分，count 恒为 0。
+struct unrolledNodeBase {
+    unrolledNodeBase* prev;
+    unrolledNodeBase* next;
+    size_t            count;    // 节点中的元素个数
+    unrolledNodeBase() : prev(nullptr), next(nullptr), count(0) {}
+};
+
+// 每个节点连续存放至多 Capacity 个元素。
+template <class T, size_t Capacity>
+struct unrolledNode : unrolledNodeBase {
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type buffer[Capacity];
+
+    T* data() { return reinterpret_cast<T*>(buffer); }
+};
+
+// 展开链表迭代器：所在节点与节点内下标。
+// end() 为 (哨兵, 0)，Value 为 const T 时是 const_iterator。
+template <class T, size_t Capacity, class Value>
+struct unrolledListIterator {
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type        = typename std::remove_const<Value>::type;
+    using difference_type   = ptrdiff_t;
+    using pointer           = Value*;
+    using reference         = Value&;
+
+    using nodeType = unrolledNode<T, Capacity>;
+
+    unrolledNodeBase* node;
+    size_t            index;
+
+    explicit unrolledListIterator(unrolledNodeBase* n = nullptr, size_t i = 0)
+            : node(n), index(i) {}
+    // iterator 可以隐式转换为 const_iterator。
+    template <class U, class = typename std::enable_if<
+                               std::is_same<const U, Value>::value
+                               && !std::is_same<U, Value>::value>::type>
+    unrolledListIterator(const unrolledListIterator<T, Capacity, U>& other)
+            : node(other.node), index(other.index) {}
+
+    unrolledListIterator& operator++() {
+        if (++index == node->count) {
+            node  = node->next;
+            index = 0;
+        }
+        return *this;
+    }
+    unrolledListIterator operator++(int) {
+        auto res = *this;
+        ++*this;
+        return res;
+    }
+    unrolledListIterator& operator--() {
+        if (index == 0) {
+            node  = node->prev;
+            index = node->count;
+        }
+        --index;
+        return *this;
+    }
+    unrolledListIterator operator--(int) {
+        auto res = *this;
+        --*this;
+        return res;
+    }
+    bool operator==(const unrolledListIterator& other) const {
+        return node == other.node && index == other.index;
+    }
+    bool operator!=(const unrolledListIterator& other) const {
+        return !(*this == other);
+    }
+
+    Value& operator*() const {
+        return static_cast<nodeType*>(node)->data()[index];
+    }
+    Value* operator->() const { return &(operator*()); }
+};
+}    // namespace detail
+
+// 展开链表：每个节点连续存放多个元素，节点约占 NodeBytes 字节
+// （默认 4 个缓存行）。
+// 顺序遍历时每个节点只有一次指针跳转，其余都是连续访问；
+// 中间插入、删除只需移动同一节点内的元素，节点满时对半分裂，
+// 相邻两个节点的元素合起来不足半个节点时合并。
+//
+// 迭代器失效规则：插入、删除使被修改节点（分裂、合并时还包括相邻节点）中的
+// 迭代器失效，其余节点中元素的迭代器保持有效。
+//
+// 节点从 nodePool 中分配。与 extrastl::list 一样，默认每个链表有自己的
+// 节点池，在插入第一个元素时创建，析构时整块归还内存；也可以在构造时传入
+// 节点池让多个链表共用。节点池非线程安全，共用节点池的链表不能在不同线程中
+// 同时修改。
+template <class T, size_t NodeBytes = 256>
+class unrolled_list {
+  public:
+    // 每个节点容纳的元素个数，至少为 1。
+    static const size_t CAPACITY =
+            NodeBytes > sizeof(detail::unrolledNodeBase) + sizeof(T)
+                    ? (NodeBytes - sizeof(detail::unrolledNodeBase)) / sizeof(T)
+                    : 1;
+
+  private:
+    using nodeBase = detail::unrolledNodeBase;
+    using nodeType = detail::unrolledNode<T, CAPACITY>;
+
+  public:
+    using value_type      = T;
+    using iterator        = detail::unrolledListIterator<T, CAPACITY, T>;
+    using const_iterator  = detail::unrolledListIterator<T, CAPACITY, const T>;
+    using reference       = T&;
+    using const_reference = const T&;
+    using size_type       = size_t;
+    using pool_type       = nodePool<nodeType>;
+
+  private:
+    // 环形链表的哨兵，next 指向第一个节点，prev 指向最后一个节点。
+    nodeBase                   sentinel_;
+    size_type                  size_;
+    std::shared_ptr<pool_type> pool_;    // 为空时在第一次分配节点时创建
+
+  public:
+    // **************************************************************
+    // ************************构造函数*******************************
+    // **************************************************************
+    // 不分配内存，节点池在插入第一个元素时创建。
+    unrolled_list() noexcept : unrolled_list(std::shared_ptr<pool_type>()) {}
+    // pool 为空时与默认构造相同，使用自己的节点池。
+    explicit unrolled_list(std::shared_ptr<pool_type> pool) noexcept
+            : size_(0), pool_(std::move(pool)) {
+        sentinel_.prev = sentinel_.next = &sentinel_;
+    }
+    explicit unrolled_list(size_type n, const value_type& val = value_type())
+            : unrolled_list() {
+        insert(end(), n, val);
+    }
+    template <class InputIterator>
+    unrolled_list(InputIterator first, InputIterator last) : unrolled_list() {
+        insert(end(), first, last);
+    }
+    unrolled_list(const unrolled_list& l) : unrolled_list() {
+        insert(end(), l.begin(), l.end());
+    }
+    // 接管 l 的全部节点与节点池，不分配内存，l 变为空链表。
+    unrolled_list(unrolled_list&& l) noexcept : unrolled_list() { swap(l); }
+    // 赋值后仍使用自身原来的节点池。
+    unrolled_list& operator=(const unrolled_list& l) {
+        if (this != &l) {
+            unrolled_list temp(pool());
+            temp.insert(temp.end(), l.begin(), l.end());
+            swap(temp);
+        }
+        return *this;
+    }
+    // 节点池随元素一起转移。
+    unrolled_list& operator=(unrolled_list&& l) noexcept {
+        if (this != &l) {
+            unrolled_list temp(std::move(l));
+            swap(temp);
+        }
+        return *this;
+    }
+    ~unrolled_list() { clear(); }
+
+    // **************************************************************
+    // ************************元素访问*******************************
+    // **************************************************************
+    reference front() { return *begin(); }
+    reference back() { return *--end(); }
+
+    // **************************************************************
+    // ***************************容量********************************
+    // **************************************************************
+    bool      empty() const { return size_ == 0; }
+    size_type size() const { return size_; }
+
+    // **************************************************************
+    // ***************************迭代器********************************
+    // **************************************************************
+    iterator       begin() { return iterator(sentinel_.next, 0); }
+    iterator       end() { return iterator(&sentinel_, 0); }
+    const_iterator begin() const { return const_iterator(sentinel_.next, 0); }
+    const_iterator end() const {
+        return const_iterator(const_cast<nodeBase*>(&sentinel_), 0);
+    }
+
+    // **************************************************************
+    // ***************************修改********************************
+    // **************************************************************
+    void push_front(const value_type& val) { emplace(begin(), val); }
+    void push_front(value_type&& val) { emplace(begin(), std::move(val)); }
+    void push_back(const value_type& val) { emplace(end(), val); }
+    void push_back(value_type&& val) { emplace(end(), std::move(val)); }
+
+    template <class... Args>
+    reference emplace_front(Args&&... args) {
+        return *emplace(begin(), std::forward<Args>(args)...);
+    }
+    template <class... Args>
+    reference emplace_back(Args&&... args) {
+        return *emplace(end(), std::forward<Args>(args)...);
+    }
+
+    void popfront() { erase(begin()); }
+    void popback() { erase(--end()); }
+
+    // 在 position 之前原地构造元素，返回指向新元素的迭代器。
+    template <class... Args>
+    iterator emplace(const_iterator position, Args&&... args) {
+        nodeBase* n = position.node;
+        size_type i = position.index;
+        // 插入到节点开头时，前一个节点未满则追加到前一个节点末尾。
+        if (i == 0 && n->prev != &sentinel_ && n->prev->count < CAPACITY) {
+            n = n->prev;
+            i = n->count;
+        }
+        if (n == &sentinel_ || (i == 0 && n->count == CAPACITY)) {
+            // 在 n 之前新建一个节点。
+            nodeType* m = newNode();
+            try {
+                ::new (static_cast<void*>(m->data()))
+                        T(std::forward<Args>(args)...);
+            } catch (...) {
+                pool_->deallocate(m);
+                throw;
+            }
+            linkBefore(n, m);
+            m->count = 1;
+            ++size_;
+            return iterator(m, 0);
+        }
+        if (i == n->count) {
+            // 追加到未满节点的末尾，不需要移动元素。
+            ::new (static_cast<void*>(data(n) + i))
+                    T(std::forward<Args>(args)...);
+            ++n->count;
+            ++size_;
+            return iterator(n, i);
+        }
+
+        // 参数可能引用被移动的元素，先构造出临时对象。
+        value_type temp(std::forward<Args>(args)...);
+        if (n->count == CAPACITY) {
+            nodeBase* m = split(n);
+            if (i > n->count) {
+                i -= n->count;
+                n = m;
+            }
+        }
+        T* pos = data(n) + i;
+        detail::shiftRight(pos, data(n) + n->count, 1);
+        ::new (static_cast<void*>(pos)) T(std::move(temp));
+        ++n->count;
+        ++size_;
+        return iterator(n, i);
+    }
+
+    iterator insert(const_iterator position, const value_type& val) {
+        return emplace(position, val);
+    }
+    iterator insert(const_iterator position, value_type&& val) {
+        return emplace(position, std::move(val));
+    }
+    void insert(const_iterator position, size_type n, const value_type& val) {
+        insert_aux(position, n, val,
+                   typename std::is_integral<size_type>::type());
+    }
+    template <class InputIterator>
+    void insert(const_iterator position, InputIterator first,
+                InputIterator last) {
+        insert_aux(position, first, last,
+                   typename std::is_integral<InputIterator>::type());
+    }
+
+    iterator erase(const_iterator position) {
+        nodeBase* n = position.node;
+        size_type i = position.index;
+        T*        d = data(n);
+        detail::shiftLeft(d + i + 1, d + n->count, d + i);
+        d[n->count - 1].~T();
+        --n->count;
+        --size_;
+
+        if (n->count == 0) {
+            nodeBase* next = n->next;
+            unlink(n);
+            deleteNode(n);
+            return iterator(next, 0);
+        }
+        mergeWithNext(n);
+        if (i == n->count) return iterator(n->next, 0);
+        return iterator(n, i);
+    }
+    iterator erase(const_iterator first, const_iterator last) {
+        // 逐个删除时 last 可能因节点合并而失效，按剩余个数计数。
+        auto n = std::distance(first, last);
+        while (n-- != 0) first = erase(first);
+        return iterator(first.node, first.index);
+    }
+
+    void clear() {
+        nodeBase* n = sentinel_.next;
+        while (n != &sentinel_) {
+            nodeBase* next = n->next;
+            destroy(data(n), data(n) + n->count);
+            deleteNode(n);
+            n = next;
+        }
+        sentinel_.prev = sentinel_.next = &sentinel_;
+        size_                           = 0;
+    }
+
+    // 交换两个链表的内容，需要修正首尾节点指向哨兵的指针。
+    void swap(unrolled_list& x) noexcept {
+        std::swap(sentinel_.prev, x.sentinel_.prev);
+        std::swap(sentinel_.next, x.sentinel_.next);
+        std::swap(size_, x.size_);
+        pool_.swap(x.pool_);
+        fixSentinel(&x.sentinel_);
+        x.fixSentinel(&sentinel_);
+    }
+
+  private:
+    static T* data(nodeBase* n) { return static_cast<nodeType*>(n)->data(); }
+
+    static void destroy(T* first, T* last) {
+        for (; first != last; ++first) first->~T();
+    }
+
+    // 节点池，尚未创建时创建一个本链表独占的节点池。
+    const std::shared_ptr<pool_type>& pool() {
+        if (pool_ == nullptr) pool_ = std::make_shared<pool_type>();
+        return pool_;
+    }
+
+    nodeType* newNode() { return ::new (pool()->allocate()) nodeType; }
+    void      deleteNode(nodeBase* n) {
+        pool_->deallocate(static_cast<nodeType*>(n));
+    }
+
+    static void linkBefore(nodeBase* position, nodeBase* n) {
+        n->next              = position;
+        n->prev              = position->prev;
+        position->prev->next = n;
+        position->prev       = n;
+    }
+    static void unlink(nodeBase* n) {
+        n->prev->next = n->next;
+        n->next->prev = n->prev;
+    }
+
+    // 将满节点 n 的后一半元素搬到新节点中，新节点接在 n 之后并返回。
+    nodeBase* split(nodeBase* n) {
+        nodeType*       m    = newNode();
+        const size_type half = CAPACITY / 2;
+        try {
+            detail::uninitializedRelocate(data(n) + half, data(n) + n->count,
+                                          m->data());
+        } catch (...) {
+            deleteNode(m);
+            throw;
+        }
+        destroy(data(n) + half, data(n) + n->count);
+        m->count = n->count - half;
+        n->count = half;
+        linkBefore(n->next, m);
+        return m;
+    }
+
+    // n 与后一个节点的元素合起来不超过半个节点时，把后一个节点并入 n。
+    void mergeWithNext(nodeBase* n) {
+        nodeBase* next = n->next;
+        if (next == &sentinel_ || n->count + next->count > CAPACITY / 2) return;
+        detail::uninitializedRelocate(data(next), data(next) + next->count,
+                                      data(n) + n->count);
+        destroy(data(next), data(next) + next->count);
+        n->count += next->count;
+        unlink(next);
+        deleteNode(next);
+    }
+
+    // swap 之后，把仍指向 oldSentinel 的首尾节点改为指向自身的哨兵。
+    void fixSentinel(nodeBase* oldSentinel) {
+        if (sentinel_.next == oldSentinel) {
+            sentinel_.prev = sentinel_.next = &sentinel_;
+        } else {
+            sentinel_.next->prev = &sentinel_;
+            sentinel_.prev->next = &sentinel_;
+        }
+    }
+
+    template <class Integer>
+    void insert_aux(const_iterator position, Integer n, const T& val,
+                    std::true_type) {
+        for (auto i = n; i != 0; --i) position = ++emplace(position, val);
+    }
+    template <class InputIterator>
+    void insert_aux(const_iterator position, InputIterator first,
+                    InputIterator last, std::false_type) {
+        for (; first != last; ++first) position = ++emplace(position, *first);
+    }
+};
+
+template <class T, size_t NodeBytes>
+const size_t unrolled_list<T, NodeBytes>::CAPACITY;
+
+template <class T, size_t NodeBytes>
+void swap(unrolled_list<T, NodeBytes>& x, unrolled_list<T, NodeBytes>& y) {
+    x.swap(y);
+}
+
+template <class T, size_t NodeBytes>
+bool operator==(const unrolled_list<T, NodeBytes>& lhs,
+                const unrolled_list<T, NodeBytes>& rhs) {
+    return lhs.size() == rhs.size()
+           && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+template <class T, size_t NodeBytes>
+bool operator!=(const unrolled_list<T, NodeBytes>& lhs,
+                const unrolled_list<T, NodeBytes>& rhs) {
+    return !(lhs == rhs);
+}
+}    // namespace extrastl
+
+#endif
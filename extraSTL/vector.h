@@ -4,12 +4,154 @@
 #include <algorithm>
 #include <memory>
 #include <type_traits>
+#include <utility>
 #include <cassert>
+#include <cstring>
 
 namespace extrastl {
+namespace detail {
 
+// 将 [first, last) 中的元素搬迁到未初始化的 dest 处，返回搬迁后的尾后位置。
+// 搬迁后源区间中的元素仍需由调用者析构。
+//
+// 可平凡复制的类型直接按字节 memcpy；
+// 其余类型使用 move_if_noexcept，移动构造可能抛异常时退化为复制，以保证强异常安全。
 template <class T>
-class vector {
+T* uninitializedRelocate(T* first, T* last, T* dest, std::true_type) {
+    const auto n = last - first;
+    if (n != 0) { std::memcpy(dest, first, n * sizeof(T)); }
+    return dest + n;
+}
+
+template <class T>
+T* uninitializedRelocate(T* first, T* last, T* dest, std::false_type) {
+    T* cur = dest;
+    try {
+        for (; first != last; ++first, ++cur) {
+            ::new (static_cast<void*>(cur)) T(std::move_if_noexcept(*first));
+        }
+    } catch (...) {
+        for (; dest != cur; ++dest) { dest->~T(); }
+        throw;
+    }
+    return cur;
+}
+
+template <class T>
+T* uninitializedRelocate(T* first, T* last, T* dest) {
+    return uninitializedRelocate(
+            first, last, dest, typename std::is_trivially_copyable<T>::type());
+}
+
+// 将 [first, last) 整体向后移动 n 个位置，[last, last + n) 为未初始化空间。
+// 完成后 [first, first + n) 成为未初始化空间，由调用者在其上构造新元素。
+//
+// 可平凡复制的类型用一次 memmove 完成；其余类型落在未初始化空间的部分移动构造，
+// 其余部分移动赋值，最后析构空出来的元素。
+template <class T>
+void shiftRight(T* first, T* last, size_t n, std::true_type) {
+    if (first != last) {
+        std::memmove(first + n, first, (last - first) * sizeof(T));
+    }
+}
+
+template <class T>
+void shiftRight(T* first, T* last, size_t n, std::false_type) {
+    if (n == 0) return;
+    for (T* p = last; p != first;) {
+        --p;
+        if (p + n >= last)
+            ::new (static_cast<void*>(p + n)) T(std::move(*p));
+        else
+            *(p + n) = std::move(*p);
+    }
+    for (T* p = first; p != last && p != first + n; ++p) { p->~T(); }
+}
+
+template <class T>
+void shiftRight(T* first, T* last, size_t n) {
+    shiftRight(first, last, n, typename std::is_trivially_copyable<T>::type());
+}
+
+// 将 [first, last) 移动到 dest（dest < first）开始的位置，返回移动后的尾后位置。
+// 尾后位置之后原有的元素仍需由调用者析构。
+template <class T>
+T* shiftLeft(T* first, T* last, T* dest, std::true_type) {
+    const auto n = last - first;
+    if (n != 0) { std::memmove(dest, first, n * sizeof(T)); }
+    return dest + n;
+}
+
+template <class T>
+T* shiftLeft(T* first, T* last, T* dest, std::false_type) {
+    return std::move(first, last, dest);
+}
+
+template <class T>
+T* shiftLeft(T* first, T* last, T* dest) {
+    return shiftLeft(first, last, dest,
+                     typename std::is_trivially_copyable<T>::type());
+}
+
+// 在未初始化的 [first, last) 上默认初始化（而非值初始化）元素，返回 last。
+// 可平凡默认构造的类型什么也不做，内存中保留原有内容。
+template <class T>
+T* uninitializedDefaultInit(T*, T* last, std::true_type) {
+    return last;
+}
+
+template <class T>
+T* uninitializedDefaultInit(T* first, T* last, std::false_type) {
+    T* cur = first;
+    try {
+        for (; cur != last; ++cur) { ::new (static_cast<void*>(cur)) T; }
+    } catch (...) {
+        for (; first != cur; ++first) { first->~T(); }
+        throw;
+    }
+    return cur;
+}
+
+template <class T>
+T* uninitializedDefaultInit(T* first, T* last) {
+    return uninitializedDefaultInit(
+            first, last,
+            typename std::is_trivially_default_constructible<T>::type());
+}
+
+// 判断分配器是否提供 T* reallocate(T* p, size_t oldN, size_t newN)，
+// 提供时 vector 扩容可以交给分配器原地完成（见 mmap_allocator.h）。
+template <class Alloc, class = void>
+struct hasReallocate : std::false_type {};
+
+template <class Alloc>
+struct hasReallocate<
+        Alloc,
+        decltype(void(std::declval<Alloc&>().reallocate(
+                std::declval<typename Alloc::value_type*>(), size_t(),
+                size_t())))> : std::true_type {};
+
+// 分配器的所有实例是否都相等。C++14 的 allocator_traits 没有
+// is_always_equal，分配器未声明时与 C++17 一样按是否为空类判断。
+template <class Alloc, class = void>
+struct allocIsAlwaysEqual : std::is_empty<Alloc> {};
+
+template <class Alloc>
+struct allocIsAlwaysEqual<
+        Alloc, decltype(void(typename Alloc::is_always_equal()))>
+        : Alloc::is_always_equal {};
+}    // namespace detail
+
+// 默认初始化标记，传给构造函数时新元素只做默认初始化，
+// 对可平凡默认构造的类型不会清零，用法见 vector::resize_for_overwrite。
+struct default_init_t {
+    explicit default_init_t() = default;
+};
+constexpr default_init_t default_init{};
+
+// Allocator 以私有继承的方式保存，无状态分配器（如 std::allocator）不占用额外空间。
+template <class T, class Allocator = std::allocator<T>>
+class vector : private Allocator {
   public:
     using value_type      = T;
     using iterator        = T*;
@@ -19,9 +161,16 @@ class vector {
     using const_reference = const T&;
     using size_type       = size_t;
     using difference_type = ptrdiff_t;
-    using allocator_type  = std::allocator<T>;
+    using allocator_type  = Allocator;
 
   private:
+    using allocTraits = std::allocator_traits<Allocator>;
+    // 元素可平凡复制且分配器提供 reallocate 时，扩容交给分配器原地完成，
+    // 不再分配新空间逐个搬迁。
+    using reallocateInPlace = std::integral_constant<
+            bool, std::is_trivially_copyable<T>::value
+                          && detail::hasReallocate<Allocator>::value>;
+
     T* start_;
     T* finish_;
     T* endOfStorage_;
@@ -31,17 +180,41 @@ class vector {
     // ************************构造函数*******************************
     // **************************************************************
     vector() : start_(0), finish_(0), endOfStorage_(0) {}
-    explicit vector(const size_type n) { allocateAndFillN(n, value_type()); }
-    vector(const size_type n, const value_type& value) {
+    explicit vector(const allocator_type& a)
+            : Allocator(a), start_(0), finish_(0), endOfStorage_(0) {}
+    explicit vector(const size_type       n,
+                    const allocator_type& a = allocator_type())
+            : Allocator(a) {
+        allocateAndFillN(n, value_type());
+    }
+    vector(const size_type n, const value_type& value,
+           const allocator_type& a = allocator_type())
+            : Allocator(a) {
         allocateAndFillN(n, value);
     }
+    vector(const size_type n, default_init_t,
+           const allocator_type& a = allocator_type())
+            : Allocator(a) {
+        allocateAndConstruct(n, [n](T* dest) {
+            detail::uninitializedDefaultInit(dest, dest + n);
+        });
+    }
     template <class InputIterator>
-    vector(InputIterator first, InputIterator last) {
+    vector(InputIterator first, InputIterator last,
+           const allocator_type& a = allocator_type())
+            : Allocator(a) {
         vector_aux(first, last,
                    typename std::is_integral<InputIterator>::type());
     }
-    vector(const vector& v) { allocateAndCopy(v.start_, v.finish_); }
-    vector(vector&& v) {
+    vector(const vector& v)
+            : Allocator(allocTraits::select_on_container_copy_construction(
+                      v.allocRef())) {
+        allocateAndCopy(v.start_, v.finish_);
+    }
+    vector(const vector& v, const allocator_type& a) : Allocator(a) {
+        allocateAndCopy(v.start_, v.finish_);
+    }
+    vector(vector&& v) noexcept : Allocator(std::move(v.allocRef())) {
         start_        = v.start_;
         finish_       = v.finish_;
         endOfStorage_ = v.endOfStorage_;
@@ -50,21 +223,33 @@ class vector {
 
     ~vector() { destroyAndDeallocateAll(); }
 
+    // 复制抛出异常时 *this 为空（基本异常安全）。
     vector& operator=(const vector& v) {
-        if (this != &v) { allocateAndCopy(v.start_, v.finish_); }
+        if (this != &v) {
+            destroyAndDeallocateAll();
+            copyAssignAllocator(
+                    v,
+                    typename allocTraits::
+                            propagate_on_container_copy_assignment::type());
+            allocateAndCopy(v.start_, v.finish_);
+        }
         return *this;
     }
-    vector& operator=(vector&& v) {
+    // 分配器随移动传播或总是相等时直接接管 v 的内存，不会抛出异常。
+    vector& operator=(vector&& v) noexcept(
+            allocTraits::propagate_on_container_move_assignment::value
+            || detail::allocIsAlwaysEqual<Allocator>::value) {
         if (this != &v) {
-            destroyAndDeallocateAll();
-            start_        = v.start_;
-            finish_       = v.finish_;
-            endOfStorage_ = v.endOfStorage_;
-            v.start_ = v.finish_ = v.endOfStorage_ = 0;
+            moveAssign(
+                    v,
+                    typename allocTraits::
+                            propagate_on_container_move_assignment::type());
         }
         return *this;
     }
 
+    allocator_type get_allocator() const { return allocRef(); }
+
     // **************************************************************
     // ***************************迭代器********************************
     // **************************************************************
@@ -84,28 +269,14 @@ class vector {
 
     // 调整 capacity 大小
     void reserve(size_type n) {
-        allocator_type alloc;
         if (n <= capacity()) return;
-        T* newStart  = alloc.allocate(n);
-        T* newFinish = std::uninitialized_copy(begin(), end(), newStart);
-        destroyAndDeallocateAll();
-
-        start_        = newStart;
-        finish_       = newFinish;
-        endOfStorage_ = start_ + n;
+        reallocateStorage(n);
     }
 
     // 将 vector 的 capacity 收缩至 size。
-    // 重新分配一块 size 大小的空间，将 0 - size-1 的数据复制过去。
+    // 重新分配一块 size 大小的空间，将 0 - size-1 的数据搬迁过去。
     // 并释放原 capacity 大小的空间。
-    void shrink_to_fit() {
-        allocator_type alloc;
-        T*             t = static_cast<T*>(alloc.allocate(size()));
-        finish_          = std::uninitialized_copy(start_, finish_, t);
-        alloc.deallocate(start_, capacity());
-        start_        = t;
-        endOfStorage_ = finish_;
-    };
+    void shrink_to_fit() { reallocateStorage(size()); };
 
     // **************************************************************
     // ************************元素访问*******************************
@@ -122,31 +293,67 @@ class vector {
     // ***************************修改********************************
     // **************************************************************
     void clear() {
-        allocator_type alloc;
-        alloc.destroy(start_, finish_);
+        destroy(start_, finish_);
         finish_ = start_;
     }
 
+    // 分配器不随 swap 传播时，两者的分配器必须相等。
     void swap(vector& v) {
         if (this != &v) {
+            swapAllocator(
+                    v,
+                    typename allocTraits::propagate_on_container_swap::type());
             std::swap(start_, v.start_);
             std::swap(finish_, v.finish_);
             std::swap(endOfStorage_, v.endOfStorage_);
         }
     }
 
-    void push_back(const value_type& value) { insert(end(), value); }
+    void push_back(const value_type& value) { emplace_back(value); }
+    void push_back(value_type&& value) { emplace_back(std::move(value)); }
+
+    // 在尾部原地构造元素。只有空间已满时才转入 reallocateAndEmplace。
+    template <class... Args>
+    reference emplace_back(Args&&... args) {
+        if (finish_ != endOfStorage_) {
+            allocTraits::construct(allocRef(), finish_,
+                                   std::forward<Args>(args)...);
+            ++finish_;
+        } else {
+            reallocateAndEmplace(finish_, std::forward<Args>(args)...);
+        }
+        return back();
+    }
+
+    // 在 position 处原地构造元素，返回指向新元素的迭代器。
+    template <class... Args>
+    iterator emplace(const_iterator position, Args&&... args) {
+        const auto index = position - cbegin();
+        iterator   pos   = start_ + index;
+        if (pos == finish_) {
+            emplace_back(std::forward<Args>(args)...);
+        } else if (finish_ != endOfStorage_) {
+            // 参数可能引用自身元素，先构造出临时对象再移动后部元素。
+            value_type temp(std::forward<Args>(args)...);
+            detail::shiftRight(pos, finish_, 1);
+            allocTraits::construct(allocRef(), pos, std::move(temp));
+            ++finish_;
+        } else {
+            reallocateAndEmplace(pos, std::forward<Args>(args)...);
+        }
+        return start_ + index;
+    }
 
     void pop_back() {
-        allocator_type alloc;
         --finish_;
-        alloc.destroy(finish_);
+        allocTraits::destroy(allocRef(), finish_);
     }
 
     iterator insert(iterator position, const value_type& val) {
-        const auto index = position - begin();
-        insert(position, 1, val);
-        return begin() + index;
+        return emplace(position, val);
+    }
+    iterator insert(iterator position, value_type&& val) {
+        return emplace(position, std::move(val));
     }
 
     void insert(iterator position, const size_type& n, const value_type& val) {
@@ -161,61 +368,127 @@ class vector {
     }
 
     void resize(size_type n, value_type val = value_type()) {
-        allocator_type alloc;
         if (n < size()) {
-            alloc.destroy(start_ + n, finish_);
+            destroy(start_ + n, finish_);
             finish_ = start_ + n;
         } else if (n > size() && n <= capacity()) {
             auto lengthOfInsert = n - size();
             finish_ = std::uninitialized_fill_n(finish_, lengthOfInsert, val);
         } else if (n > capacity()) {
             auto lengthOfInsert = n - size();
-            T*   newStart  = alloc.allocate(getNewCapacity(lengthOfInsert));
-            T*   newFinish = std::uninitialized_copy(begin(), end(), newStart);
-            newFinish =
-                    std::uninitialized_fill_n(newFinish, lengthOfInsert, val);
+            reallocateStorage(getNewCapacity(lengthOfInsert));
+            finish_ = std::uninitialized_fill_n(finish_, lengthOfInsert, val);
+        }
+    }
 
-            destroyAndDeallocateAll();
-            start_        = newStart;
-            finish_       = newFinish;
-            endOfStorage_ = start_ + n;
+    // 与 resize 相同，但新增的元素只做默认初始化。
+    // 对 char、int 等可平凡默认构造的类型不会清零，
+    // 适合随后立即被 read()、解码等整体覆盖的缓冲区。
+    void resize_for_overwrite(size_type n) {
+        if (n < size()) {
+            destroy(start_ + n, finish_);
+            finish_ = start_ + n;
+        } else if (n > size()) {
+            if (n > capacity()) {
+                reallocateStorage(getNewCapacity(n - size()));
+            }
+            finish_ = detail::uninitializedDefaultInit(finish_, start_ + n);
         }
     }
 
     iterator erase(iterator position) { return erase(position, position + 1); }
     iterator erase(iterator first, iterator last) {
-        difference_type lenOfTail    = end() - last;
-        difference_type lenOfRemoved = last - first;
-        finish_                      = finish_ - lenOfRemoved;
-        for (; lenOfTail != 0; --lenOfTail) {
-            auto temp = (last - lenOfRemoved);
-            *temp     = *(last++);
-        }
+        if (first == last) return first;
+        // 可平凡复制的类型析构为空操作，memmove 覆盖被删元素即可。
+        iterator newFinish = detail::shiftLeft(last, finish_, first);
+        destroy(newFinish, finish_);
+        finish_ = newFinish;
         return (first);
     }
 
   private:
+    allocator_type&       allocRef() { return *this; }
+    const allocator_type& allocRef() const { return *this; }
+
+    void copyAssignAllocator(const vector& v, std::true_type) {
+        allocRef() = v.allocRef();
+    }
+    void copyAssignAllocator(const vector&, std::false_type) {}
+
+    // 分配器可以传播：直接接管 v 的内存。
+    void moveAssign(vector& v, std::true_type) {
+        destroyAndDeallocateAll();
+        allocRef()    = std::move(v.allocRef());
+        start_        = v.start_;
+        finish_       = v.finish_;
+        endOfStorage_ = v.endOfStorage_;
+        v.start_ = v.finish_ = v.endOfStorage_ = 0;
+    }
+    // 分配器不可传播：相等时仍可接管内存，否则只能逐个移动元素。
+    void moveAssign(vector& v, std::false_type) {
+        if (allocRef() == v.allocRef()) {
+            destroyAndDeallocateAll();
+            start_        = v.start_;
+            finish_       = v.finish_;
+            endOfStorage_ = v.endOfStorage_;
+            v.start_ = v.finish_ = v.endOfStorage_ = 0;
+        } else {
+            destroyAndDeallocateAll();
+            allocateAndCopy(std::make_move_iterator(v.start_),
+                            std::make_move_iterator(v.finish_));
+            v.clear();
+        }
+    }
+
+    void swapAllocator(vector& v, std::true_type) {
+        using std::swap;
+        swap(allocRef(), v.allocRef());
+    }
+    void swapAllocator(vector& v, std::false_type) {
+        assert(allocRef() == v.allocRef());
+    }
+
+    void destroy(T* first, T* last) {
+        for (; first != last; ++first) {
+            allocTraits::destroy(allocRef(), first);
+        }
+    }
+
+    // 析构全部元素并释放空间，之后 vector 为空，可以重新分配。
     void destroyAndDeallocateAll() {
-        allocator_type alloc;
-        if (capacity() != 0) {
-            for (auto i = start_; i < finish_; i++) { alloc.destroy(i); }
-            alloc.deallocate(start_, capacity());
+        if (start_ != 0) {
+            destroy(start_, finish_);
+            allocTraits::deallocate(allocRef(), start_, capacity());
         }
+        start_ = finish_ = endOfStorage_ = 0;
     }
 
+    // 分配 n 个元素的空间并构造元素，调用前 vector 不能持有空间。
+    // 构造抛出异常时释放新空间，vector 仍不持有空间。
     void allocateAndFillN(const size_type n, const value_type& value) {
-        allocator_type alloc;
-        start_ = alloc.allocate(n);
-        std::uninitialized_fill_n(start_, n, value);
-        finish_ = endOfStorage_ = start_ + n;
+        allocateAndConstruct(n, [&](T* dest) {
+            std::uninitialized_fill_n(dest, n, value);
+        });
     }
 
     template <class InputIterator>
     void allocateAndCopy(InputIterator first, InputIterator last) {
-        allocator_type alloc;
-        start_        = alloc.allocate(last - first);
-        finish_       = std::uninitialized_copy(first, last, start_);
-        endOfStorage_ = finish_;
+        allocateAndConstruct(last - first, [&](T* dest) {
+            std::uninitialized_copy(first, last, dest);
+        });
+    }
+
+    template <class Construct>
+    void allocateAndConstruct(const size_type n, Construct construct) {
+        T* newStart = allocTraits::allocate(allocRef(), n);
+        try {
+            construct(newStart);
+        } catch (...) {
+            allocTraits::deallocate(allocRef(), newStart, n);
+            throw;
+        }
+        start_  = newStart;
+        finish_ = endOfStorage_ = newStart + n;
     }
 
     template <class InputIterator>
@@ -232,20 +505,12 @@ class vector {
     void insert_aux(iterator position, InputIterator first, InputIterator last,
                     std::false_type) {
         difference_type locationLeft = endOfStorage_ - finish_;
-        difference_type locationNeed = distance(first, last);
+        difference_type locationNeed = std::distance(first, last);
 
+        if (locationNeed == 0) return;
         if (locationLeft >= locationNeed) {
-            if (finish_ - position > locationNeed) {
-                std::uninitialized_copy(finish_ - locationNeed, finish_,
-                                        finish_);
-                std::copy_backward(position, finish_ - locationNeed, finish_);
-                std::copy(first, last, position);
-            } else {
-                iterator temp = std::uninitialized_copy(
-                        first + (finish_ - position), last, finish_);
-                std::uninitialized_copy(position, finish_, temp);
-                std::copy(first, first + (finish_ - position), position);
-            }
+            detail::shiftRight(position, finish_, locationNeed);
+            std::uninitialized_copy(first, last, position);
             finish_ += locationNeed;
         } else {
             reallocateAndCopy(position, first, last);
@@ -255,20 +520,16 @@ class vector {
     template <class Integer>
     void insert_aux(iterator position, Integer n, const value_type& value,
                     std::true_type) {
-        allocator_type alloc;
-        assert(n != 0);
+        if (n == 0) return;
         difference_type locationLeft =
                 endOfStorage_ - finish_;    // the size of left storage
         difference_type locationNeed = n;
 
         if (locationLeft >= locationNeed) {
-            auto tempPtr = end() - 1;
-            for (; tempPtr - position >= 0;
-                 --tempPtr) {    //move the [position, finish_) back
-                //*(tempPtr + locationNeed) = *tempPtr;//bug
-                alloc.construct(tempPtr + locationNeed, *tempPtr);
-            }
-            std::uninitialized_fill_n(position, n, value);
+            // value 可能引用即将被移动的元素，先复制一份。
+            value_type temp(value);
+            detail::shiftRight(position, finish_, locationNeed);
+            std::uninitialized_fill_n(position, n, temp);
             finish_ += locationNeed;
         } else {
             reallocateAndFillN(position, n, value);
@@ -278,36 +539,97 @@ class vector {
     template <class InputIterator>
     void reallocateAndCopy(iterator position, InputIterator first,
                            InputIterator last) {
-        allocator_type  alloc;
-        difference_type newCapacity = getNewCapacity(last - first);
-
-        T* newStart        = alloc.allocate(newCapacity);
-        T* newEndOfStorage = newStart + newCapacity;
-        T* newFinish = std::uninitialized_copy(begin(), position, newStart);
-        newFinish    = std::uninitialized_copy(first, last, newFinish);
-        newFinish    = std::uninitialized_copy(position, end(), newFinish);
-
-        destroyAndDeallocateAll();
-        start_        = newStart;
-        finish_       = newFinish;
-        endOfStorage_ = newEndOfStorage;
+        // [first, last) 可能来自自身，在 reallocateAround 搬迁旧元素之前复制。
+        const size_type n = last - first;
+        reallocateAround(position, n, getNewCapacity(n), [&](T* dest) {
+            std::uninitialized_copy(first, last, dest);
+        });
     }
 
     void reallocateAndFillN(iterator position, const size_type& n,
                             const value_type& val) {
-        allocator_type  alloc;
-        difference_type newCapacity = getNewCapacity(n);
+        // val 可能引用自身元素，同样先填充新元素。
+        reallocateAround(position, n, getNewCapacity(n), [&](T* dest) {
+            std::uninitialized_fill_n(dest, n, val);
+        });
+    }
 
-        T* newStart        = alloc.allocate(newCapacity);
-        T* newEndOfStorage = newStart + newCapacity;
-        T* newFinish = std::uninitialized_copy(begin(), position, newStart);
-        newFinish    = std::uninitialized_fill_n(newFinish, n, val);
-        newFinish    = std::uninitialized_copy(position, end(), newFinish);
+    // 将容量调整为 newCapacity（不小于 size），元素保持不变。
+    void reallocateStorage(size_type newCapacity) {
+        reallocateStorage(newCapacity, reallocateInPlace());
+    }
+
+    // 交给分配器的 reallocate 调整空间，例如 mmapAllocator 通过 mremap 重新映射页表。
+    void reallocateStorage(size_type newCapacity, std::true_type) {
+        const size_type n = size();
+        start_        = allocRef().reallocate(start_, capacity(), newCapacity);
+        finish_       = start_ + n;
+        endOfStorage_ = start_ + newCapacity;
+    }
+
+    void reallocateStorage(size_type newCapacity, std::false_type) {
+        reallocateAround(finish_, 0, newCapacity, [](T*) {});
+    }
+
+    // 空间已满时在 position 处构造一个新元素。
+    template <class... Args>
+    void reallocateAndEmplace(iterator position, Args&&... args) {
+        reallocateAndEmplace(reallocateInPlace(), position,
+                             std::forward<Args>(args)...);
+    }
+
+    // 原地扩容后旧空间随即失效，参数可能引用自身元素，因此先构造出临时对象。
+    template <class... Args>
+    void reallocateAndEmplace(std::true_type, iterator position,
+                              Args&&... args) {
+        value_type temp(std::forward<Args>(args)...);
+        const auto index = position - start_;
+        reallocateStorage(getNewCapacity(1));
+        emplace(start_ + index, std::move(temp));
+    }
+
+    // 参数可能引用自身元素，reallocateAround 会先构造新元素再搬迁旧元素。
+    template <class... Args>
+    void reallocateAndEmplace(std::false_type, iterator position,
+                              Args&&... args) {
+        reallocateAround(position, 1, getNewCapacity(1), [&](T* dest) {
+            allocTraits::construct(allocRef(), dest,
+                                   std::forward<Args>(args)...);
+        });
+    }
+
+    // 分配 newCapacity 大小的新空间，先由 construct(dest) 在 position 对应的
+    // 位置构造 n 个新元素，再搬迁 position 前后两段旧元素，最后释放旧空间。
+    //
+    // 任何一步抛出异常时析构新空间中已构造的元素并释放新空间，
+    // vector 保持原样（强异常安全）：搬迁只在移动构造不抛异常时移动，
+    // 否则复制，旧元素在成功之前不会被改动。
+    template <class Construct>
+    void reallocateAround(iterator position, size_type n,
+                          size_type newCapacity, Construct construct) {
+        allocator_type& alloc     = allocRef();
+        T*              newStart  = allocTraits::allocate(alloc, newCapacity);
+        T*              inserted  = newStart + (position - start_);
+        T*              newFinish = inserted;    // 新元素及后段的尾后位置
+        T*              prefixEnd = newStart;    // 前段的尾后位置
+        try {
+            construct(inserted);
+            newFinish = inserted + n;
+            prefixEnd =
+                    detail::uninitializedRelocate(start_, position, newStart);
+            newFinish =
+                    detail::uninitializedRelocate(position, finish_, newFinish);
+        } catch (...) {
+            destroy(newStart, prefixEnd);
+            destroy(inserted, newFinish);
+            allocTraits::deallocate(alloc, newStart, newCapacity);
+            throw;
+        }
 
         destroyAndDeallocateAll();
         start_        = newStart;
         finish_       = newFinish;
-        endOfStorage_ = newEndOfStorage;
+        endOfStorage_ = newStart + newCapacity;
     }
 
     size_type getNewCapacity(size_type len) const {